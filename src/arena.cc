@@ -0,0 +1,72 @@
+/*----------------------------------------------------------------------
+  File    : arena.cc
+  Contents: Bump allocator for the syntax tree
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "arena.h"
+
+/*----------------------------------------------------------------------
+  Main Methods
+----------------------------------------------------------------------*/
+
+arena::arena (size_t block_size)
+  : _free (NULL), _end (NULL), _block_size (block_size), 
+    _next_size (block_size), _used (0) {
+}
+
+/* --------------------------------------------------------------------*/
+
+arena::~arena () {
+  for (size_t i = 0; i < _blocks.size (); ++i) {
+    delete [] _blocks[i];
+  }
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- start a new block (a larger one, if the request will not fit in
+   the next block) and allocate from that */
+void* arena::grow (size_t n, size_t align) {
+  size_t size = n + align > _next_size ? n + align : _next_size;
+  _next_size  = 2 * size;
+  _blocks.push_back (new char[size]);
+  _free = _blocks.back ();
+  _end  = _free + size;
+  return allocate (n, align);
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- everything goes back at once; the first block is kept, since the
+   next compilation will only want it again */
+void arena::release () {
+  for (size_t i = 1; i < _blocks.size (); ++i) {
+    delete [] _blocks[i];
+  }
+  if (!_blocks.empty ()) {
+    _blocks.resize (1);
+    _free = _blocks[0];
+    _end  = _free + _block_size;
+  }
+  _next_size = 2 * _block_size;
+  _used      = 0;
+}
+
+/* --------------------------------------------------------------------*/
+
+size_t arena::used () const {
+  return _used;
+}
+
+/*----------------------------------------------------------------------
+  Emacs Configuration
+  Local Variables:
+  mode: C++
+  End:
+----------------------------------------------------------------------*/
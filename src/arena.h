@@ -0,0 +1,77 @@
+/*----------------------------------------------------------------------
+  File    : arena.h
+  Contents: Bump allocator for the syntax tree
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*----------------------------------------------------------------------
+  Arena - memory handed out by bumping a pointer through large blocks,
+  and given back all at once.  Each block is twice the size of the one
+  before, so a tree of n bytes takes only log n trips to the heap.
+  Nothing allocated from it is ever destroyed, so only objects with
+  trivial destructors may live here (which make() checks).
+----------------------------------------------------------------------*/
+
+class arena {
+
+private:
+
+  std::vector<char*> _blocks;   /* every block, the newest last */
+  char              *_free;     /* unused part of the newest block */
+  char              *_end;
+  size_t             _block_size; /* of the first block, */
+  size_t             _next_size;  /* and of the next one */
+  size_t             _used;     /* bytes handed out since the release */
+
+  arena (arena const&);
+  arena& operator= (arena const&);
+
+  void* grow (size_t, size_t);
+
+public:
+
+  explicit arena (size_t = 64 * 1024);
+  ~arena ();
+
+  /* --- n bytes, aligned to align (a power of two) */
+  void* allocate (size_t n, size_t align) {
+    size_t pad = -reinterpret_cast<size_t> (_free) & (align - 1);
+    if (n + pad > static_cast<size_t> (_end - _free)) {
+      return grow (n, align);
+    }
+    char *p = _free + pad;
+    _free  = p + n;
+    _used += n;
+    return p;
+  }
+
+  template <typename T, typename... Args> T* make (Args&&... args) {
+    static_assert (std::is_trivially_destructible<T>::value,
+		   "an arena never runs destructors");
+    return new (allocate (sizeof (T), alignof (T)))
+      T (std::forward<Args> (args)...);
+  }
+
+  void   release ();            /* free everything, in one step */
+  size_t used () const;
+
+};
+
+#endif
+
+/*----------------------------------------------------------------------
+  Emacs Configuration
+  Local Variables:
+  mode: C++
+  End:
+----------------------------------------------------------------------*/
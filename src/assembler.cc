@@ -1,250 +1,176 @@
 
+#include <charconv>
+#include <cstdlib>
 #include <iostream>
 #include "assembler.h"
+#include "opcode.h"
 using namespace std;
 
+// Size of the blocks the program is written out in.
+#define BLOCKSIZE 65536
+
 // Simple constructor.
-Assembler::Assembler(istream &in, ostream &out)
+Assembler::Assembler(ostream &out)
 {
    currentAddress = 0;
-   for (int i = 0; i < MAXLABEL; i++)
-      labelTable[i] = 0;
-   insource = &in;
    outsource = &out;
+   outcode = &buffer;
+   done = false;
+}
+
+// Assemble straight into memory, for running the program in-process.
+Assembler::Assembler(vector<int> &out)
+{
+   currentAddress = 0;
+   outsource = NULL;
+   outcode = &out;
+   outcode->clear();
+   done = false;
 }
 
 // Default destructor.
 Assembler::~Assembler()
 { }
 
-// The first pass of the assmebler.  This just builds the labelTable.
-// Don't translate just yet.
-void Assembler::firstPass()
+// Append one machine word to the program.
+void Assembler::put(int word)
 {
-   // Start at address 0 (not 1 as I had previously thought)
-   currentAddress = 0;
-   string nextop;
-   (*insource) >> nextop;
-   // Loop until we find the ENDPROG operation.
-   for (;;) {
-      // Record the current address in the label table.
-      if (nextop == "DEFADDR") {
-	 int index;
-	 (*insource) >> index;
-	 labelTable[index] = currentAddress;
-	 (*insource) >> nextop;
-      }
-      // Record the associated value in the label table.
-      else if (nextop == "DEFARG") {
-	 int index, value;
-	 (*insource) >> index >> value;
-	 labelTable[index] = value;
-	 (*insource) >> nextop;
-      }
-      // Stop when we find ENDPROG.
-      else if (nextop == "ENDPROG")
-	 return;
-      else if (nextop == "ARROW" || nextop == "ASSIGN" || nextop == "BAR" ||
-	       nextop == "CONSTANT" || nextop == "FI" || nextop == "READ" ||
-	       nextop == "WRITE") {
-	 // Skip one machine words.
-	 (*insource) >> nextop;
-	 (*insource) >> nextop;
-	 currentAddress += 2;
-      }
-      else if (nextop == "CALL" || nextop == "INDEX" || nextop == "PROC" ||
-	       nextop == "PROG" || nextop == "VARIABLE") {
-	 // Skip two machine words.
-	 (*insource) >> nextop;
-	 (*insource) >> nextop;
-	 (*insource) >> nextop;
-	 currentAddress += 3;
-      }
-      else {
-	 // just get the next machine word.
-	 (*insource) >> nextop;
-	 currentAddress++;
-      }
+   outcode->push_back(word);
+   currentAddress++;
+}
+
+// Append a word holding the value of a label.  If the label is not
+// defined yet, the word joins the label's chain of forward references,
+// to be backpatched when it is.
+void Assembler::reference(int label)
+{
+   if (label < 0) {
+      // We should never see this message.
+      cerr << "Assembler encountered an invalid label: " << label
+	   << ".  Bailing...\n";
+      exit(2);
    }
+   if (label >= (int) labelTable.size()) {
+      labelTable.resize(label + 1, -1);
+      labelDefined.resize(label + 1, false);
+   }
+   put(labelTable[label]);
+   if (!labelDefined[label])
+      labelTable[label] = outcode->size() - 1;
 }
 
-// The second pass of the assembler.  Here we actually translate operations
-// to their opcodes.
-void Assembler::secondPass()
+// Give a label its value, and patch every word that was waiting for it.
+void Assembler::define(int label, int value)
 {
-   string nextop;
-   (*insource) >> nextop;
-   // Loop until ENDPROG.
-   for (;;) {
-     if (nextop == "ADD") {
-	 (*outsource) << 0 << endl;;
-	 currentAddress++;
-      }
-      else if (nextop == "AND") {
-	 (*outsource) << 1 << endl;;
-	 currentAddress++;
-      }
-      else if (nextop == "ARROW") {
-	 (*outsource) << 2 << endl;;
-	 int temp;
-	 (*insource) >> temp;
-	 // Output the absolute jump address.
-	 (*outsource) << labelTable[temp] << endl;
-	 currentAddress += 2;
-      }
-      else if (nextop == "ASSIGN") {
-	 (*outsource) << 3 << endl;
-	 int temp;
-	 (*insource) >> temp;
-	 (*outsource) << temp << endl;
-	 currentAddress += 2;
-      }
-      else if (nextop == "BAR") {
-	 (*outsource) << 4 << endl;
-	 int temp;
-	 (*insource) >> temp;
-	 (*outsource) << labelTable[temp] << endl;
-	 currentAddress += 2;
-      }
-      else if (nextop == "CALL") {
-	 (*outsource) << 5 << endl;
-	 int temp;
-	 (*insource) >> temp;
-	 (*outsource) << temp << endl;
-	 (*insource) >> temp;
-	 (*outsource) << labelTable[temp] << endl;
-	 currentAddress += 3;
-      }
-      else if (nextop == "CONSTANT") {
-	 (*outsource) << 6 << endl;
-	 int temp;
-	 (*insource) >> temp;
-	 (*outsource) << temp << endl;
-	 currentAddress += 2;
-      }
-      else if (nextop == "DIVIDE") {
-	 (*outsource) << 7 << endl;
-	 currentAddress++;
-      }
-      else if (nextop == "ENDPROC") {
-	 (*outsource) << 8 << endl;
-	 currentAddress++;
-      }
-      else if (nextop == "ENDPROG") {
-	 (*outsource) << 9 << endl;
+   if (label >= (int) labelTable.size()) {
+      labelTable.resize(label + 1, -1);
+      labelDefined.resize(label + 1, false);
+   }
+   for (int next, at = labelTable[label]; !labelDefined[label] && at >= 0;
+	at = next) {
+      next = (*outcode)[at];
+      (*outcode)[at] = value;
+   }
+   labelTable[label] = value;
+   labelDefined[label] = true;
+}
+
+// Assemble one instruction.  The records already hold the opcodes, so
+// all there is to do is resolve the labels.
+void Assembler::instruction(ir::instruction const &next)
+{
+   // Stop after ENDPROG.
+   if (done)
+      return;
+   switch (next.op) {
+   // Record the current address.
+   case ir::define_address:
+      define(next.x, currentAddress);
+      break;
+   // Record the associated value.
+   case ir::define_argument:
+      define(next.x, next.y);
+      break;
+   // Output the absolute jump address.
+   case opcode::arrow:
+   case opcode::bar:
+      put(next.op);
+      reference(next.x);
+      break;
+   case opcode::call:
+      put(next.op);
+      put(next.x);
+      reference(next.y);
+      break;
+   // Both the block length and the address are labels.
+   case opcode::procedure:
+   case opcode::program:
+      put(next.op);
+      reference(next.x);
+      reference(next.y);
+      break;
+   default:
+      switch (opcode::length(next.op)) {
+      case 1:
+	 put(next.op);
 	 break;
-      }
-      else if (nextop == "EQUAL") {
-	 (*outsource) << 10 << endl;
-	 currentAddress++;
-      }
-      else if (nextop == "FI") {
-	 (*outsource) << 11 << endl;
-	 int temp;
-	 (*insource) >> temp;
-	 (*outsource) << temp << endl;
-	 currentAddress += 2;
-      }
-      else if (nextop == "GREATER") {
-	 (*outsource) << 12 << endl;
-	 currentAddress++;
-      }
-      else if (nextop == "INDEX") {
-	 (*outsource) << 13 << endl;
-	 int temp;
-	 (*insource) >> temp;
-	 (*outsource) << temp << endl;
-	 (*insource) >> temp;
-	 (*outsource) << temp << endl;
-	 currentAddress += 3;
-      }
-      else if (nextop == "LESS") {
-	 (*outsource) << 14 << endl;
-	 currentAddress++;
-      }
-      else if (nextop == "MINUS") {
-	 (*outsource) << 15 << endl;
-	 currentAddress++;
-      }
-      else if (nextop == "MODULO") {
-	 (*outsource) << 16 << endl;
-	 currentAddress++;
-      }
-      else if (nextop == "MULTIPLY") {
-	 (*outsource) << 17 << endl;
-	 currentAddress++;
-      }
-      else if (nextop == "NOT") {
-	 (*outsource) << 18 << endl;
-	 currentAddress++;
-      }
-      else if (nextop == "OR") {
-	 (*outsource) << 19 << endl;
-	 currentAddress++;
-      }
-      else if (nextop == "PROC") {
-	 (*outsource) << 20 << endl;
-	 int temp;
-	 (*insource) >> temp;
-	 (*outsource) << labelTable[temp] << endl;
-	 (*insource) >> temp;
-	 (*outsource) << labelTable[temp] << endl;
-	 currentAddress += 3;
-      }
-      else if (nextop == "PROG") {
-	 (*outsource) << 21 << endl;
-	 int temp;
-	 (*insource) >> temp;
-	 (*outsource) << labelTable[temp] << endl;
-	 (*insource) >> temp;
-	 (*outsource) << labelTable[temp] << endl;
-	 currentAddress += 3;
-      }
-      else if (nextop == "READ") {
-	 (*outsource) << 22 << endl;
-	 int temp;
-	 (*insource) >> temp;
-	 (*outsource) << temp << endl;
-	 currentAddress += 2;
-      }
-      else if (nextop == "SUBTRACT") {
-	 (*outsource) << 23 << endl;
-	 currentAddress++;
-      }
-      else if (nextop == "VALUE") {
-	 (*outsource) << 24 << endl;
-	 currentAddress++;
-      }
-      else if (nextop == "VARIABLE") {
-	 (*outsource) << 25 << endl;
-	 int temp;
-	 (*insource) >> temp;
-	 (*outsource) << temp << endl;
-	 (*insource) >> temp;
-	 (*outsource) << temp << endl;
-	 currentAddress += 3;
-      }
-      else if (nextop == "WRITE") {
-	 (*outsource) << 26 << endl;
-	 int temp;
-	 (*insource) >> temp;
-	 (*outsource) << temp << endl;
-	 currentAddress += 2;
-      }
-      else if (nextop == "DEFADDR") {
-	 int temp;
-	 (*insource) >> temp;
-      }
-      else if (nextop == "DEFARG") {
-	 int temp1, temp2;
-	 (*insource) >> temp1 >> temp2;
-      }
-      else {
+      case 2:
+	 put(next.op);
+	 put(next.x);
+	 break;
+      case 3:
+	 put(next.op);
+	 put(next.x);
+	 put(next.y);
+	 break;
+      default:
 	 // We should never see this message.
-	cerr << "Assembler encountered an unknown operator: `" 
-	     << nextop << "'.  Bailing...\n";
-	exit(2);
+	 cerr << "Assembler encountered an unknown operator: `" 
+	      << next.op << "'.  Bailing...\n";
+	 exit(2);
       }
-      (*insource) >> nextop;
    }
+   if (next.op == opcode::end_program)
+      done = true;
+}
+
+// Resolve whatever is still waiting (labels that were never defined
+// are 0, as they always were), then write the program out if it is
+// going to a file.
+void Assembler::finish()
+{
+   for (unsigned int i = 0; i < labelTable.size(); i++)
+      if (!labelDefined[i])
+	 define(i, 0);
+   if (!outsource)
+      return;
+   // Format the words a block at a time, rather than flushing the
+   // stream after each one.
+   char block[BLOCKSIZE];
+   size_t used = 0;
+   for (unsigned int i = 0; i < buffer.size(); i++) {
+      if (used > BLOCKSIZE - 16) {
+	 outsource->write(block, used);
+	 used = 0;
+      }
+      used = to_chars(block + used, block + BLOCKSIZE, buffer[i]).ptr - block;
+      block[used++] = '\n';
+   }
+   outsource->write(block, used);
+   outsource->flush();
+}
+
+// Number of words assembled.
+size_t Assembler::size() const
+{
+   return outcode->size();
+}
+
+// Assemble a whole program, in a single pass over it.
+void Assembler::assemble(ir::code const &in)
+{
+   ir::code::const_iterator next = in.begin();
+   for (; next != in.end(); ++next)
+      instruction(*next);
+   finish();
 }
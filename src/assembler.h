@@ -3,22 +3,35 @@
 #define ASSEMBLER_H
 
 #include <iostream>
-
-#define MAXLABEL 1000
+#include <vector>
+#include "ir.h"
 
 class Assembler
 {
   public:
-  Assembler(std::istream &in, std::ostream &out);
+  Assembler(std::ostream &out);
+  Assembler(std::vector<int> &out);
   ~Assembler();
-  // The two passes of the assembler.
-  void firstPass(); 
-  void secondPass();
+  // Assemble a whole program in one pass.
+  void assemble(ir::code const &in);
+  // Or feed it one instruction at a time, then finish.
+  void instruction(ir::instruction const &next);
+  void finish();
+  // Number of words assembled.
+  size_t size() const;
   
  private:
-  int labelTable[MAXLABEL]; 
+  // For each label, its value once defined; until then, the head of
+  // the chain of words waiting for it (each holds the next, -1 ends).
+  std::vector<int> labelTable;
+  std::vector<char> labelDefined;
   int currentAddress; 
-  std::istream *insource;  // Input file
   std::ostream *outsource; // Output file 
+  std::vector<int> buffer; // Words assembled so far (writing a file)
+  std::vector<int> *outcode; // Output buffer
+  bool done; // ENDPROG seen
+  void put(int word);
+  void reference(int label);
+  void define(int label, int value);
 };
 #endif
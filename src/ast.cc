@@ -1,6 +1,6 @@
 /*----------------------------------------------------------------------
   File    : ast.cc
-  Contents: 
+  Contents: Abstract syntax tree nodes
   Author  : Ben Burnett
   History : 08.02.2007 file created
 ----------------------------------------------------------------------*/
@@ -10,108 +10,183 @@
 #endif 
 
 #include "ast.h"
-
-using namespace ast;
+#include <type_traits>
 
 /*----------------------------------------------------------------------
   Namespace Inclusions
 ----------------------------------------------------------------------*/
 
+using namespace ast;
+
 /*----------------------------------------------------------------------
   Constants
 ----------------------------------------------------------------------*/
 
-/*----------------------------------------------------------------------
-  Friend Functions/Operators
-----------------------------------------------------------------------*/
+/* --- nodes live in an arena, which never runs their destructors */
+static_assert (std::is_trivially_destructible<access>::value
+	       && std::is_trivially_destructible<block>::value,
+	       "AST nodes must be trivially destructible");
 
 /*----------------------------------------------------------------------
-  Exceptions
+  AST Nodes
 ----------------------------------------------------------------------*/
 
+ast::ast::ast (node::code k, unsigned at) 
+  : kind (k), offset (at) {
+}
+
 /*----------------------------------------------------------------------
-  AST Nodes
+  Expressions
 ----------------------------------------------------------------------*/
 
-ast::ast::ast () {
+expression::expression (node::code k, unsigned at, token const & t, 
+			type::code type) 
+  : ast (k, at), op (t), type (type), next (NULL) {
 }
 
 /*--------------------------------------------------------------------*/
 
-int ast::ast::line () const {
-  return _line;
+constant::constant (unsigned at, token const & t, type::code type, 
+		    int value)
+  : expression (node::constant, at, t, type), value (value) {
 }
- 
+
 /*--------------------------------------------------------------------*/
 
-int ast::ast::column () const {
-  return _column;
+identifier::identifier (unsigned at, token const & t, type::code type, 
+			int level, int displacement)
+  : expression (node::identifier, at, t, type), level (level), 
+    displacement (displacement) {
 }
 
-/*----------------------------------------------------------------------
-  Expressions
-----------------------------------------------------------------------*/
+/*--------------------------------------------------------------------*/
 
-expression::expression (token const & op, type::code t) 
-  : _op (op), _type (t) {
+identifier::identifier (node::code k, unsigned at, token const & t, 
+			type::code type, int level, int displacement)
+  : expression (k, at, t, type), level (level), 
+    displacement (displacement) {
 }
 
 /*--------------------------------------------------------------------*/
 
-type::code expression::type () const {
-  return _type;
+access::access (unsigned at, token const & t, type::code type, int level, 
+		int displacement, expression *index, int upper, int line, 
+		unsigned selector)
+  : identifier (node::access, at, t, type, level, displacement), 
+    index (index), upper (upper), line (line), selector (selector) {
+}
+
+/*----------------------------------------------------------------------
+  Operators
+----------------------------------------------------------------------*/
+
+unary::unary (unsigned at, token const & t, type::code type, 
+	      expression *operand)
+  : expression (node::unary, at, t, type), operand (operand) {
 }
 
 /*--------------------------------------------------------------------*/
 
-void expression::set_type (type::code t) {
-  _type = t;
+binary::binary (unsigned at, token const & t, type::code type, 
+		expression *left, expression *right)
+  : expression (node::binary, at, t, type), left (left), right (right) {
 }
 
 /*----------------------------------------------------------------------
-  Expression : identifier
+  Statements
 ----------------------------------------------------------------------*/
 
-identifier::identifier (token const & op, type::code t, int b) 
-  : expression (op, t), _offset (b) {
+statement::statement (node::code k, unsigned at) 
+  : ast (k, at), next (NULL) {
 }
 
 /*--------------------------------------------------------------------*/
 
-identifier::operator int () const {
-  return _offset;
+empty::empty (unsigned at) 
+  : statement (node::empty, at) {
 }
 
-/*----------------------------------------------------------------------
-  Expression : constant
-----------------------------------------------------------------------*/
+/*--------------------------------------------------------------------*/
 
-constant::constant (token const & op, type::code t)
-  : expression (op, t) {
+read::read (unsigned at, list<expression> const & variables) 
+  : statement (node::read, at), variables (variables) {
 }
 
 /*--------------------------------------------------------------------*/
 
-void constant::set_value (token const & val) {
-  _op = val;
+write::write (unsigned at, list<expression> const & expressions) 
+  : statement (node::write, at), expressions (expressions) {
 }
 
-/*----------------------------------------------------------------------
-  Operators
-----------------------------------------------------------------------*/
+/*--------------------------------------------------------------------*/
 
-/*----------------------------------------------------------------------
-  Operator : op
-----------------------------------------------------------------------*/
+assignment::assignment (unsigned at, list<expression> const & variables,
+			list<expression> const & expressions) 
+  : statement (node::assignment, at), variables (variables), 
+    expressions (expressions) {
+}
+
+/*--------------------------------------------------------------------*/
+
+call::call (unsigned at, int level, int label) 
+  : statement (node::call, at), level (level), label (label) {
+}
+
+/*--------------------------------------------------------------------*/
+
+guarded_command::guarded_command (unsigned at, expression *guard, 
+				  list<statement> const & statements,
+				  int entry, int exit, unsigned start, 
+				  unsigned arrow) 
+  : ast (node::guarded_command, at), guard (guard), 
+    statements (statements), entry (entry), exit (exit), start (start), 
+    arrow (arrow), next (NULL) {
+}
+
+/*--------------------------------------------------------------------*/
+
+if_statement::if_statement (unsigned at, 
+			    list<guarded_command> const & commands, 
+			    int done, int line) 
+  : statement (node::if_statement, at), commands (commands), done (done),
+    line (line) {
+}
+
+/*--------------------------------------------------------------------*/
 
-op::op (token const & tok, type::code t)
-  : expression (tok, t) {
+do_statement::do_statement (unsigned at, 
+			    list<guarded_command> const & commands, 
+			    int loop) 
+  : statement (node::do_statement, at), commands (commands), loop (loop) {
 }
 
 /*----------------------------------------------------------------------
-  Operator : access
+  Blocks
 ----------------------------------------------------------------------*/
 
-ast::access::access (identifier a, expression i, type::code t) 
-  : op (token (INDEX, "[]"), t), _array (a), _index (i) {
+block::block (unsigned at, list<procedure> const & procedures, 
+	      list<statement> const & statements, int variables, 
+	      int variable, int begin, unsigned opening, unsigned body) 
+  : ast (node::block, at), procedures (procedures), 
+    statements (statements), variables (variables), variable (variable),
+    begin (begin), opening (opening), body (body) {
+}
+
+/*--------------------------------------------------------------------*/
+
+procedure::procedure (unsigned at, block *body, int label) 
+  : ast (node::procedure, at), body (body), label (label), next (NULL) {
 }
+
+/*--------------------------------------------------------------------*/
+
+program::program (unsigned at, block *body) 
+  : ast (node::program, at), body (body) {
+}
+
+/*----------------------------------------------------------------------
+  Emacs Configuration
+  Local Variables:
+  mode: C++
+  End:
+----------------------------------------------------------------------*/
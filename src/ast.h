@@ -1,6 +1,6 @@
 /*----------------------------------------------------------------------
   File    : ast.h
-  Contents: 
+  Contents: Abstract syntax tree nodes
   Author  : Ben Burnett
   History : 08.02.2007 file created
 ----------------------------------------------------------------------*/
@@ -9,274 +9,304 @@
 #define AST_H
 
 #include "token.h"
+#include <cstddef>
+
+/*----------------------------------------------------------------------
+  Abstract Syntax Tree - built by the parser, a whole program at a time,
+  in an arena (see arena.h), and read by the code generator.  Nodes
+  are plain records with no destructors: the tree is thrown away by
+  releasing the arena.  Names are already resolved (a variable carries
+  its level difference and displacement), and the labels are already
+  numbered, in the order the parser met them.
+
+  Every node records the source offset the parser had reached when it
+  finished with it (that is, of the token after it), which the code
+  generator passes on with each instruction for the line table.
+----------------------------------------------------------------------*/
 
 namespace ast {
 
 /*----------------------------------------------------------------------
-  Forward Declarations
+  Node Codes
 ----------------------------------------------------------------------*/
 
+namespace node {
+  enum code {
+    constant, identifier, access, unary, binary,
+    empty, read, write, assignment, call, if_statement, do_statement,
+    guarded_command, procedure, block, program
+  };
+}
+
 /*----------------------------------------------------------------------
-  Abstract Syntax Tree node
+  Lists - nodes are chained through their own next field, and a list
+  knows both ends, so appending is constant time
 ----------------------------------------------------------------------*/
 
-class ast {
+template <typename T> struct list {
 
-  friend class parser;          /* all derived class will now be friendly 
-				   with the parser ... that is, they'll
-				   show it their protected members */
+  T  *first, *last;
+  int count;
 
-protected:
- 
-  int        _column,           /* node's column number */
-             _line;             /* node's line number */
-  
-public:
+  list () : first (NULL), last (NULL), count (0) {}
 
-  ast ();
-  
-  int line () const;
-  int column () const;
+  void append (T *n) {
+    n->next = NULL;
+    if (last) {
+      last->next = n;
+    } else {
+      first = n;
+    }
+    last = n;
+    ++count;
+  }
 
 };
 
 /*----------------------------------------------------------------------
-  Expressions
+  Abstract Syntax Tree node
 ----------------------------------------------------------------------*/
 
-class expression : public ast {
+struct ast {
 
-protected:
-  
-  token      _op;
-  type::code _type;
-  
-public:
+  node::code kind;
+  unsigned   offset;            /* where the parser finished with it */
 
-  expression (token const & = token (), type::code = type::universal);
-  
-  type::code type () const;
-  void set_type (type::code);
+  ast (node::code, unsigned);
 
 };
 
-/*--------------------------------------------------------------------*/
-
-class identifier : public expression {
+/*----------------------------------------------------------------------
+  Expressions
+----------------------------------------------------------------------*/
 
-private:
-  
-  int _offset;
-  
-public:
+struct expression : public ast {
 
-  identifier (token const &, type::code, int);
-  /* -- might be able to get type from the token */
+  token       op;               /* the operator, or the operand's token */
+  type::code  type;
+  expression *next;             /* in an expression or variable list */
 
-  operator int () const;
+  expression (node::code, unsigned, token const&, type::code);
 
 };
 
 /*--------------------------------------------------------------------*/
 
-class constant : public expression {
+struct constant : public expression {
 
-public:
-  
-  constant (token const &, type::code = type::universal);
+  int value;
 
-  static constant true$;
-  static constant false$;
-
-  void set_value (token const &);
+  constant (unsigned, token const&, type::code, int);
 
 };
 
-/*----------------------------------------------------------------------
-  Operators
-----------------------------------------------------------------------*/
+/*--------------------------------------------------------------------*/
+
+/* --- a variable, by its place in the activation records */
+struct identifier : public expression {
+
+  int level,                    /* scopes out from the current one */
+      displacement;
 
-class op : public expression {
+  identifier (unsigned, token const&, type::code, int, int);
 
-public:
+protected:
 
-  op (token const &, type::code);
+  identifier (node::code, unsigned, token const&, type::code, int, int);
 
 };
 
 /*--------------------------------------------------------------------*/
 
-class binary : public op {
+/* --- an element of an array variable */
+struct access : public identifier {
 
-public:
+  expression *index;
+  int         upper,            /* the array's size */
+              line;             /* of the "[", for the range check */
+  unsigned    selector;         /* offset of the "[" */
 
-  binary ();
+  access (unsigned, token const&, type::code, int, int, expression*,
+	  int, int, unsigned);
 
 };
 
-/*--------------------------------------------------------------------*/
+/*----------------------------------------------------------------------
+  Operators - the token code (MINUS, LOGICAL_AND, LESS_THAN, ...) says
+  which
+----------------------------------------------------------------------*/
 
-class unary : public op {
+struct unary : public expression {
 
-public:
+  expression *operand;
 
-  unary ();
+  unary (unsigned, token const&, type::code, expression*);
 
 };
 
 /*--------------------------------------------------------------------*/
 
-class access : public op {
-
-private:
-
-  identifier _array;
-  expression _index;
+struct binary : public expression {
 
-public:
+  expression *left,
+             *right;
 
-  access (identifier, expression, type::code);
-
-  identifier const & get_array () const;
-  expression const & get_index () const;
+  binary (unsigned, token const&, type::code, expression*, expression*);
 
 };
 
 /*----------------------------------------------------------------------
-  Logical operators
+  Statements
+
+  Statement = EmptyStatement | ReadStatement | WriteStatement
+            | Assignmentstatement | ProcedureStatement | IfStatement
+	    | DoStatement .
 ----------------------------------------------------------------------*/
 
-class logical : public expression {
+struct statement : public ast {
 
-public:
+  statement *next;
 
-  logical ();
+  statement (node::code, unsigned);
 
 };
 
 /*--------------------------------------------------------------------*/
 
-class land : public logical {
-
-public:
+struct empty : public statement {
 
-  land ();
+  explicit empty (unsigned);
 
 };
 
 /*--------------------------------------------------------------------*/
 
-class lor : public logical {
+struct read : public statement {
 
-public:
+  list<expression> variables;
 
-  lor ();
+  read (unsigned, list<expression> const&);
 
 };
 
 /*--------------------------------------------------------------------*/
 
-class lnot : public logical {
+struct write : public statement {
 
-public:
+  list<expression> expressions;
 
-  lnot ();
+  write (unsigned, list<expression> const&);
 
 };
 
 /*--------------------------------------------------------------------*/
 
-class relational : public logical {
+/* --- the assignment is only made when the two sides balance */
+struct assignment : public statement {
 
-public:
+  list<expression> variables,
+                   expressions;
 
-  relational ();
-
-};
-
-/*----------------------------------------------------------------------
-  Statements
-
-  Statement = EmptyStatement | ReadStatement | WriteStatement 
-            | Assignmentstatement | ProcedureStatement | IfStatement 
-	    | DoStatement .
-----------------------------------------------------------------------*/
-
-class statement : public ast {
-
-public:
-
-  statement ();
+  assignment (unsigned, list<expression> const&, list<expression> const&);
 
 };
 
 /*--------------------------------------------------------------------*/
 
-class empty : public statement {
+struct call : public statement {
 
-public:
+  int level,                    /* scopes out to the procedure's */
+      label;                    /* the procedure's address */
 
-  empty ();
+  call (unsigned, int, int);
 
 };
 
 /*--------------------------------------------------------------------*/
 
-class if_statement : public statement {
+/* --- a guard and its statements: the code for it starts at the entry
+   label, and falls through to the exit label when the guard fails */
+struct guarded_command : public ast {
 
-public:
+  expression      *guard;
+  list<statement>  statements;
+  int              entry,
+                   exit;
+  unsigned         start,       /* offset of the guard, */
+                   arrow;       /* and of the "->" */
+  guarded_command *next;
 
-  if_statement ();
+  guarded_command (unsigned, expression*, list<statement> const&,
+		   int, int, unsigned, unsigned);
 
 };
 
 /*--------------------------------------------------------------------*/
 
-class do_statement : public statement {
+/* --- the node's offset is that of the "fi" */
+struct if_statement : public statement {
 
-public:
+  list<guarded_command> commands;
+  int                   done,   /* label after the statement */
+                        line;   /* of the "fi", for when no guard holds */
 
-  do_statement ();
+  if_statement (unsigned, list<guarded_command> const&, int, int);
 
 };
 
 /*--------------------------------------------------------------------*/
 
-class read : public statement {
+/* --- the node's offset is that of the "od" */
+struct do_statement : public statement {
 
-public:
+  list<guarded_command> commands;
+  int                   loop;   /* label at the top of the loop */
 
-  read ();
+  do_statement (unsigned, list<guarded_command> const&, int);
 
 };
 
-/*--------------------------------------------------------------------*/
+/*----------------------------------------------------------------------
+  Blocks
+----------------------------------------------------------------------*/
+
+struct procedure;
 
-class write : public statement {
+/* --- the node's offset is that of the token after "end" */
+struct block : public ast {
 
-public:
+  list<procedure> procedures;
+  list<statement> statements;
+  int             variables,    /* how many words of them */
+                  variable,     /* label defined as that number */
+                  begin;        /* label of the first statement */
+  unsigned        opening,      /* offset of "begin", */
+                  body;         /* and of the statement part */
 
-  write ();
+  block (unsigned, list<procedure> const&, list<statement> const&,
+	 int, int, int, unsigned, unsigned);
 
 };
 
 /*--------------------------------------------------------------------*/
 
-class assignment : public statement {
+struct procedure : public ast {
 
-public:
+  block     *body;
+  int        label;             /* the procedure's address */
+  procedure *next;
 
-  assignment ();
+  procedure (unsigned, block*, int);
 
 };
 
 /*--------------------------------------------------------------------*/
 
-class procedure : public statement {
+struct program : public ast {
 
-public:
+  block *body;
 
-  procedure ();
+  program (unsigned, block*);
 
 };
 
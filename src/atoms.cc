@@ -0,0 +1,209 @@
+/*----------------------------------------------------------------------
+  File    : atoms.cc
+  Contents: Interned identifier spellings
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "atoms.h"
+#include "misc.h"
+#include "token.h"
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+/*----------------------------------------------------------------------
+  Namespace Inclusions
+----------------------------------------------------------------------*/
+
+using std::vector;
+
+/*----------------------------------------------------------------------
+  Preprocessor Definitions
+----------------------------------------------------------------------*/
+
+/* --- spellings are copied in to blocks of this many bytes */
+#define BLOCK_SIZE 65536
+
+/*----------------------------------------------------------------------
+  Constants
+----------------------------------------------------------------------*/
+
+/* --- all the reserved words in PL programming language, which take
+   the first atoms, in this order */
+static const struct {
+  char const *word;
+  token_code  code;
+} reserved[] = { 
+  { "begin",   BEGIN },
+  { "end",     END },
+  { "const",   CONST },
+  { "array",   ARRAY },
+  { "integer", INTEGER },
+  { "Boolean", BOOLEAN },
+  { "proc",    PROC },
+  { "skip",    SKIP },
+  { "read",    READ },
+  { "write",   WRITE },
+  { "call",    CALL },
+  { "if",      IF },
+  { "do",      DO },
+  { "fi",      FI },
+  { "od",      OD },
+  { "false",   FALSE },
+  { "true",    TRUE }
+};
+
+const int atom::keywords = count_of (reserved);
+
+/*----------------------------------------------------------------------
+  Type Definitions
+----------------------------------------------------------------------*/
+
+namespace {
+
+  /* --- an interned spelling */
+  struct entry {
+    char const *text;
+    unsigned    length;
+    unsigned    hash;
+  };
+
+  /* --- the atoms, their spellings (in an arena of blocks that never
+     move, so names stay put), and an open-addressed index from hash
+     to atom; the index is never more than half full */
+  class table {
+
+  private:
+
+    vector<entry>  _atoms;
+    vector<int>    _index;      /* atom per slot, or atom::none */
+    vector<char*>  _blocks;
+    char          *_free;       /* unused part of the newest block */
+    size_t         _left;
+
+    char const* store (char const *s, size_t n) {
+      if (n + 1 > _left) {
+	size_t size = n + 1 > BLOCK_SIZE ? n + 1 : BLOCK_SIZE;
+	_blocks.push_back (new char[size]);
+	_free = _blocks.back ();
+	_left = size;
+      }
+      char *p = _free;
+      memcpy (p, s, n);
+      p[n] = '\0';
+      _free += n + 1;
+      _left -= n + 1;
+      return p;
+    }
+
+    void grow () {
+      vector<int> index (2 * _index.size (), atom::none);
+      size_t mask = index.size () - 1;
+      for (size_t i = 0; i < _atoms.size (); ++i) {
+	size_t h = _atoms[i].hash & mask;
+	while (atom::none != index[h]) {
+	  h = (h + 1) & mask;
+	}
+	index[h] = i;
+      }
+      _index.swap (index);
+    }
+
+  public:
+
+    table () : _index (1024, atom::none), _free (NULL), _left (0) {
+      for (size_t i = 0; i < count_of (reserved); ++i) {
+	intern (reserved[i].word, strlen (reserved[i].word));
+      }
+    }
+
+    ~table () {
+      for (size_t i = 0; i < _blocks.size (); ++i) {
+	delete [] _blocks[i];
+      }
+    }
+
+    /* -- FNV-1a */
+    static unsigned hash (char const *s, size_t n) {
+      unsigned h = 2166136261u;
+      for (size_t i = 0; i < n; ++i) {
+	h = (h ^ static_cast<unsigned char> (s[i])) * 16777619u;
+      }
+      return h;
+    }
+
+    atom::id intern (char const *s, size_t n) {
+      unsigned h    = hash (s, n);
+      size_t   mask = _index.size () - 1;
+      size_t   i    = h & mask;
+      for (; atom::none != _index[i]; i = (i + 1) & mask) {
+	entry const & e = _atoms[_index[i]];
+	if (e.hash == h && e.length == n && 0 == memcmp (e.text, s, n)) {
+	  return static_cast<atom::id> (_index[i]);
+	}
+      }
+      entry e = { store (s, n), static_cast<unsigned> (n), h };
+      atom::id a = static_cast<atom::id> (_atoms.size ());
+      _atoms.push_back (e);
+      _index[i] = a;
+      if (2 * _atoms.size () > _index.size ()) {
+	grow ();
+      }
+      return a;
+    }
+
+    entry const & at (atom::id a) const {
+      assert (a >= 0 && static_cast<size_t> (a) < _atoms.size ());
+      return _atoms[a];
+    }
+
+    size_t size () const { 
+      return _atoms.size (); 
+    }
+
+  };
+
+  /* --- the one table, made on first use */
+  table & atoms () {
+    static table t;
+    return t;
+  }
+
+}
+
+/*----------------------------------------------------------------------
+  Functions
+----------------------------------------------------------------------*/
+
+atom::id atom::intern (char const *s, size_t n) {
+  return atoms ().intern (s, n);
+}
+
+/* --------------------------------------------------------------------*/
+
+char const* atom::name (id a) {
+  return atoms ().at (a).text;
+}
+
+/* --------------------------------------------------------------------*/
+
+size_t atom::length (id a) {
+  return atoms ().at (a).length;
+}
+
+/* --------------------------------------------------------------------*/
+
+size_t atom::count () {
+  return atoms ().size ();
+}
+
+/* --------------------------------------------------------------------*/
+
+token_code atom::keyword (id a) {
+  return a >= 0 && a < keywords ? reserved[a].code : IDENTIFIER;
+}
@@ -0,0 +1,51 @@
+/*----------------------------------------------------------------------
+  File    : atoms.h
+  Contents: Interned identifier spellings
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#ifndef ATOMS_H
+#define ATOMS_H
+
+#include <cstddef>
+
+/*----------------------------------------------------------------------
+  Forward Declarations
+----------------------------------------------------------------------*/
+
+enum token_code : int;
+
+/*----------------------------------------------------------------------
+  Atom Table - every distinct word in the source is stored once, and is
+  known from then on by a small integer, so comparing two names is
+  comparing two integers.  The reserved words are interned first, in
+  a fixed order, so a word is a keyword exactly when its atom is below
+  atom::keywords.
+----------------------------------------------------------------------*/
+
+namespace atom {
+
+  enum id : int { 
+    none = -1                   /* no name at all */
+  };
+
+  id          intern (char const*, size_t);
+  char const* name (id);        /* the spelling, NUL terminated */
+  size_t      length (id);
+  size_t      count ();         /* atoms interned so far */
+
+  /* --- the keyword's token code, or IDENTIFIER for any other word */
+  token_code  keyword (id);
+  extern const int keywords;    /* the number of reserved words */
+
+}
+
+#endif
+
+/*----------------------------------------------------------------------
+  Emacs Configuration
+  Local Variables:
+  mode: C++
+  End:
+----------------------------------------------------------------------*/
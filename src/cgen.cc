@@ -0,0 +1,450 @@
+/*----------------------------------------------------------------------
+  File    : cgen.cc
+  Contents: PL machine to C translator
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "cgen.h"
+#include "interpreter.h"
+#include "misc.h"
+#include "opcode.h"
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*----------------------------------------------------------------------
+  Namespace Inclusions
+----------------------------------------------------------------------*/
+
+using std::endl;
+using std::make_pair;
+using std::ostream;
+using std::ostringstream;
+using std::pair;
+using std::string;
+using std::vector;
+
+namespace rterr = error::runtime;
+
+/*----------------------------------------------------------------------
+  Constants
+----------------------------------------------------------------------*/
+
+/* --- everything the translated program needs, bar the program */
+static const char *prelude[] = {
+  "#include <stdio.h>",
+  "#include <stdlib.h>",
+  "",
+  "/* -- arithmetic wraps around, as it does on the PL machine */",
+  "#define ADD(a, b) ((int) ((unsigned) (a) + (unsigned) (b)))",
+  "#define SUB(a, b) ((int) ((unsigned) (a) - (unsigned) (b)))",
+  "#define MUL(a, b) ((int) ((unsigned) (a) * (unsigned) (b)))",
+  "#define NEG(a)    ((int) (0u - (unsigned) (a)))",
+  ""
+};
+
+/*----------------------------------------------------------------------
+  Helper Functions
+----------------------------------------------------------------------*/
+
+/* --- name of the local holding the expression stack word k */
+static string temp (int k) {
+  ostringstream s;
+  s << "t" << k;
+  return s.str ();
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- a string as a C string literal */
+static string quote (string const & s) {
+  string r = "\"";
+  for (string::const_iterator it = s.begin (); it != s.end (); ++it) {
+    switch (*it) {
+    case '\n': r += "\\n";     break;
+    case '"':  r += "\\\"";    break;
+    case '\\': r += "\\\\";    break;
+    default:   r += *it;       break;
+    }
+  }
+  return r + "\"";
+}
+
+/*----------------------------------------------------------------------
+  Main Methods
+----------------------------------------------------------------------*/
+
+cgen::cgen (vector<int> const & code, error_interface & err,
+	    string const & source)
+  : _code (code), _errors (err), _source (source), _temps (0),
+    _uses_input (false), _uses_base (false), _uses_stack (false),
+    _uses_return (false) {
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- find the instructions, and every word that is jumped to */
+bool cgen::decode () {
+  int n = _code.size (), length;
+  _label.assign (n + 1, false);
+  for (int p = 0; p < n; p += length) {
+    length = opcode::length (_code[p]);
+    if (!length || p + length > n) {
+      _errors.error (rterr::instruction, _code[p], p);
+      return false;
+    }
+    _start.push_back (p);
+    switch (_code[p]) {
+    case opcode::arrow:
+    case opcode::bar:
+      _label[_code[p + 1]] = true;
+      break;
+    case opcode::call:
+      _label[_code[p + 2]] = true;
+      _label[p + 3] = true;
+      _returns.push_back (p + 3);
+      break;
+    case opcode::procedure:
+    case opcode::program:
+      _label[_code[p + 2]] = true;
+      break;
+    }
+  }
+  return true;
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- a block's statements run from its begin address to its ENDPROC
+   (or ENDPROG), as the code of nested procedures comes before them.
+   The program's block is level 0; a CALL n levels out from a block
+   of level l enters a block of level l - n + 1. */
+void cgen::find_levels () {
+  vector<pair<int, int> > blocks;   /* (begin, level) to visit */
+  int n = _code.size ();
+  _level.assign (n + 1, -1);
+  if (n && opcode::program == _code[0]) {
+    blocks.push_back (make_pair (_code[2], 0));
+  }
+  while (!blocks.empty ()) {
+    int p = blocks.back ().first, level = blocks.back ().second;
+    blocks.pop_back ();
+    if (p < 0 || p >= n || _level[p] >= 0) {
+      continue;                 /* (already seen) */
+    }
+    for (; p < n; p += opcode::length (_code[p])) {
+      _level[p] = level;
+      if (opcode::call == _code[p]) {
+	int proc = _code[p + 2];
+	blocks.push_back (make_pair (_code[proc + 2],
+				     level - _code[p + 1] + 1));
+      }
+      if (opcode::end_procedure == _code[p]
+	  || opcode::end_program == _code[p]) {
+	break;
+      }
+    }
+  }
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- work out how deep the expression stack is at each instruction;
+   it must be empty wherever we jump to, as it is for the code our
+   parser generates */
+bool cgen::find_depths () {
+  int depth = 0;
+  _depth.assign (_code.size () + 1, 0);
+  for (vector<int>::iterator it = _start.begin ();
+       it != _start.end (); ++it) {
+    int p = *it;
+    if (_label[p] && depth) {
+      _errors.error (rterr::instruction, _code[p], p);
+      return false;
+    }
+    _depth[p] = depth;
+    switch (_code[p]) {
+    case opcode::constant:
+    case opcode::variable:
+      ++depth;
+      break;
+    case opcode::add:      case opcode::and$:    case opcode::arrow:
+    case opcode::divide:   case opcode::equal:   case opcode::greater:
+    case opcode::index:    case opcode::less:    case opcode::modulo:
+    case opcode::multiply: case opcode::or$:     case opcode::subtract:
+      --depth;
+      break;
+    case opcode::assign:
+      depth -= 2 * _code[p + 1];
+      break;
+    case opcode::read:
+    case opcode::write:
+      depth -= _code[p + 1];
+      break;
+    case opcode::bar:      case opcode::call:    case opcode::end_procedure:
+    case opcode::end_program: case opcode::fi:   case opcode::procedure:
+    case opcode::program:
+      depth = 0;                /* (control does not fall through) */
+      break;
+    }
+    if (depth < 0) {
+      _errors.error (rterr::instruction, _code[p], p);
+      return false;
+    }
+    _temps = std::max (_temps, depth);
+  }
+  return true;
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- which of the run-time support the program needs: reading input,
+   the base register (which the links are followed from), the stack of
+   activation records, and returning from procedures */
+void cgen::find_uses () {
+  for (vector<int>::iterator it = _start.begin ();
+       it != _start.end (); ++it) {
+    int p = *it;
+    switch (_code[p]) {
+    case opcode::read:
+      _uses_input = _uses_stack = true;
+      break;
+    case opcode::end_procedure:
+      _uses_return = true;
+      /* no break */
+    case opcode::call:
+      _uses_base = _uses_stack = true;
+      break;
+    case opcode::assign:
+    case opcode::value:
+      _uses_stack = true;
+      break;
+    case opcode::variable:
+      if (!fixed (p, _code[p + 1])) {
+	_uses_base  = true;
+	_uses_stack = _uses_stack || _code[p + 1] > 0;
+      }
+      break;
+    }
+  }
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- whether a variable is at a fixed address: it is level-0 in a 
+   block whose level we know */
+bool cgen::fixed (int p, int level) const {
+  return _level[p] >= 0 && _level[p] == level;
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- the address of a variable: level-0 variables of a block whose
+   level we know are at fixed addresses, all others are found by
+   following the static links from the current block */
+string cgen::variable (int p, int level, int displacement) const {
+  ostringstream s;
+  if (fixed (p, level)) {
+    s << displacement;
+  } else {
+    string base = "b";
+    for (; level > 0; --level) {
+      base = "st[" + base + "]";
+    }
+    s << base << " + " << displacement;
+  }
+  return s.str ();
+}
+
+/* --------------------------------------------------------------------*/
+
+void cgen::instruction (ostream & out, int p) const {
+  int const *code = &_code[p];
+  int        d    = _depth[p];
+  string     a    = d > 1 ? temp (d - 2) : "", /* second from the top */
+             t    = d > 0 ? temp (d - 1) : ""; /* top of the stack */
+  if (_label[p]) {
+    out << "L" << p << ":" << endl;
+  }
+  out << "  ";
+  switch (code[0]) {
+  case opcode::add:
+    out << a << " = ADD (" << a << ", " << t << ");";
+    break;
+  case opcode::and$:
+    out << "if (" << a << ") " << a << " = " << t << ";";
+    break;
+  case opcode::arrow:
+    out << "if (!" << t << ") goto L" << code[1] << ";";
+    break;
+  case opcode::assign:
+    for (int i = 0; i < code[1]; ++i) {
+      out << "st[" << temp (d - 2 * code[1] + i) << "] = "
+	  << temp (d - code[1] + i) << "; ";
+    }
+    break;
+  case opcode::bar:
+    out << "goto L" << code[1] << ";";
+    break;
+  case opcode::call:
+    out << "x = " << variable (p, code[1], 0) << ";" << endl
+	<< "  if (s + 3 > TOP) { overflow (); }" << endl
+	<< "  st[s + 1] = x; st[s + 2] = b; st[s + 3] = " << p + 3 << ";"
+	<< endl
+	<< "  b = s + 1; s += 3; goto L" << code[2] << ";";
+    break;
+  case opcode::constant:
+    out << temp (d) << " = " << code[1] << ";";
+    break;
+  case opcode::divide:
+  case opcode::modulo:
+    out << "if (!" << t << ") { fail (DIVIDE_BY_ZERO, 0); } " << a << " = "
+	<< a << (opcode::divide == code[0] ? " / " : " % ") << t << ";";
+    break;
+  case opcode::end_procedure:
+    out << "s = b - 1; p = st[b + 2]; b = st[b + 1]; goto ret;";
+    break;
+  case opcode::end_program:
+    out << "return EXIT_SUCCESS;";
+    break;
+  case opcode::equal:
+    out << a << " = (" << a << " == " << t << ");";
+    break;
+  case opcode::fi:
+    out << "fail (IF_FAILS, " << code[1] << ");";
+    break;
+  case opcode::greater:
+    out << a << " = (" << a << " > " << t << ");";
+    break;
+  case opcode::index:
+    /* -- arrays are indexed from 1 to their bound */
+    out << "if ((unsigned) " << t << " - 1u >= " << code[1] << "u) "
+	<< "{ fail (RANGE, " << code[2] << "); } "
+	<< a << " += " << t << " - 1;";
+    break;
+  case opcode::less:
+    out << a << " = (" << a << " < " << t << ");";
+    break;
+  case opcode::minus:
+    out << t << " = NEG (" << t << ");";
+    break;
+  case opcode::multiply:
+    out << a << " = MUL (" << a << ", " << t << ");";
+    break;
+  case opcode::not$:
+    out << t << " = !" << t << ";";
+    break;
+  case opcode::or$:
+    out << "if (!" << a << ") " << a << " = " << t << ";";
+    break;
+  case opcode::procedure:
+    out << "s += " << code[1] << "; if (s > TOP) { overflow (); } goto L"
+	<< code[2] << ";";
+    break;
+  case opcode::program:
+    out << (_uses_base ? "b = 0; " : "") << "s = " << 2 + code[1]
+	<< "; if (s > TOP) { overflow (); } goto L" << code[2] << ";";
+    break;
+  case opcode::read:
+    for (int i = 0; i < code[1]; ++i) {
+      out << "input (&st[" << temp (d - code[1] + i) << "]); ";
+    }
+    break;
+  case opcode::subtract:
+    out << a << " = SUB (" << a << ", " << t << ");";
+    break;
+  case opcode::value:
+    out << t << " = st[" << t << "];";
+    break;
+  case opcode::variable:
+    out << temp (d) << " = " << variable (p, code[1], code[2]) << ";";
+    break;
+  case opcode::write:
+    for (int i = 0; i < code[1]; ++i) {
+      out << "printf (\"%d\\n\", " << temp (d - code[1] + i) << "); ";
+    }
+    break;
+  }
+  out << endl;
+}
+
+/* --------------------------------------------------------------------*/
+
+bool cgen::write (ostream & out) {
+  unsigned int i;
+  if (!decode () || !find_depths ()) {
+    return false;
+  }
+  find_levels ();
+  find_uses ();
+
+  /* --- the run-time support */
+  out << "/* " << _source << ": translated by " << PACKAGE_STRING
+      << " */" << endl << endl;
+  for (i = 0; i < count_of (prelude); ++i) {
+    out << prelude[i] << endl;
+  }
+  out << "#define TOP            " << STACK_SIZE - 1 << endl
+      << "#define RANGE          " << quote (rterr::message (rterr::range))
+      << endl
+      << "#define IF_FAILS       "
+      << quote (rterr::message (rterr::if_fails)) << endl
+      << "#define DIVIDE_BY_ZERO "
+      << quote (rterr::message (rterr::divide_by_zero)) << endl << endl;
+  if (_uses_stack) {
+    out << "static int st[TOP + 1];" << endl << endl;
+  }
+  out << "static void fail (const char *msg, int x) {" << endl
+      << "  fflush (stdout);" << endl
+      << "  fprintf (stderr, \"%s: runtime error: \", " << quote (_source)
+      << ");" << endl
+      << "  fprintf (stderr, msg, x);" << endl
+      << "  exit (EXIT_FAILURE);" << endl
+      << "}" << endl << endl
+      << "static void overflow (void) {" << endl
+      << "  fail (" << quote (rterr::message (rterr::stack_overflow))
+      << ", 0);" << endl
+      << "}" << endl << endl;
+  if (_uses_input) {
+    out << "static void input (int *x) {" << endl
+	<< "  if (1 != scanf (\"%d\", x)) {" << endl
+	<< "    fail (" << quote (rterr::message (rterr::input)) << ", 0);"
+	<< endl << "  }" << endl
+	<< "}" << endl << endl;
+  }
+
+  /* --- the program */
+  out << "int main (void) {" << endl
+      << "  int " << (_uses_base ? "b = 0, " : "") << "s = -1"
+      << (_uses_return ? ", p = 0" : "") << ";" << endl;
+  if (!_returns.empty ()) {
+    out << "  int x;" << endl;      /* (for CALL) */
+  }
+  for (int k = 0; k < _temps; ++k) {
+    out << (k ? ", " : "  int ") << temp (k);
+  }
+  out << (_temps ? ";\n" : "") << endl;
+  for (i = 0; i < _start.size (); ++i) {
+    instruction (out, _start[i]);
+  }
+  if (_uses_return) {
+    out << "ret:" << endl
+	<< "  switch (p) {" << endl;
+    for (i = 0; i < _returns.size (); ++i) {
+      out << "  case " << _returns[i] << ": goto L" << _returns[i] << ";"
+	  << endl;
+    }
+    out << "  }" << endl;
+  }
+  out << "  return EXIT_FAILURE;" << endl
+      << "}" << endl;
+  return true;
+}
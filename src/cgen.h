@@ -0,0 +1,71 @@
+/*----------------------------------------------------------------------
+  File    : cgen.h
+  Contents: PL machine to C translator
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#ifndef CGEN_H
+#define CGEN_H
+
+#include "error.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*----------------------------------------------------------------------
+  Main Class - writes an assembled program as a self-contained C
+  translation unit, to be built with the system's C compiler.
+
+  The expression stack only ever holds values within a statement (it
+  is empty at every jump target), so its words become C locals the C
+  compiler can keep in registers.  Activation records stay on a
+  stack array, linked as the machine links them; level-0 variables
+  sit at fixed addresses at its bottom (the program's globals).
+  Guarded commands become gotos, and ENDPROC returns through a switch
+  over the return addresses.  Only the support a program uses is
+  written out, so that the C builds cleanly with -Wall -Werror.
+----------------------------------------------------------------------*/
+
+class cgen {
+
+private:
+
+  std::vector<int> const &_code;  /* assembled program */
+  error_interface        &_errors; /* error manager */
+  std::string             _source; /* name of the PL source file */
+  std::vector<int>        _start; /* address of each instruction */
+  std::vector<int>        _level; /* block level of each word (or -1) */
+  std::vector<int>        _depth; /* expression stack depth at a word */
+  std::vector<bool>       _label; /* words that are jumped to */
+  std::vector<int>        _returns; /* return addresses of all CALLs */
+  int                     _temps; /* deepest expression stack */
+  bool                    _uses_input,  /* -- what the program needs: */
+                          _uses_base,   /* input (), b, */
+                          _uses_stack,  /* st, */
+                          _uses_return; /* and p with the ret: switch */
+
+  bool decode ();
+  void find_levels ();
+  bool find_depths ();
+  void find_uses ();
+
+  bool fixed (int, int) const;
+  std::string variable (int, int, int) const;
+  void instruction (std::ostream&, int) const;
+
+public:
+
+  cgen (std::vector<int> const&, error_interface&, std::string const&);
+  bool write (std::ostream&);
+
+};
+
+#endif
+
+/*----------------------------------------------------------------------
+  Emacs Configuration
+  Local Variables:
+  mode: C++
+  End:
+----------------------------------------------------------------------*/
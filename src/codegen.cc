@@ -0,0 +1,324 @@
+/*----------------------------------------------------------------------
+  File    : codegen.cc
+  Contents: Code generation from the abstract syntax tree
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif 
+
+#include "codegen.h"
+#include <cassert>
+
+/*----------------------------------------------------------------------
+  Namespace Inclusions
+----------------------------------------------------------------------*/
+
+using namespace ast;
+
+/*----------------------------------------------------------------------
+  Main Methods
+----------------------------------------------------------------------*/
+
+codegen::codegen (emitter_interface & emit) 
+  : _emitter (emit) {
+}
+
+/* --------------------------------------------------------------------*/
+
+/* Program = Block "." . */
+void codegen::program (ast::program const *p) {
+  _emitter.locate (p->body->opening);
+  _emitter.program (p->body->variable, p->body->begin);
+  block (p->body);
+  _emitter.locate (p->body->offset);
+  _emitter.end_program ();
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- each procedure's code comes first, then the block's own */
+void codegen::block (ast::block const *b) {
+  for (procedure const *p = b->procedures.first; p; p = p->next) {
+    _emitter.locate (p->body->opening);
+    _emitter.define_address (p->label);
+    _emitter.procedure (p->body->variable, p->body->begin);
+    block (p->body);
+    _emitter.locate (p->body->offset);
+    _emitter.end_procedure ();
+  }
+  _emitter.locate (b->body);
+  _emitter.define_argument (b->variable, b->variables);
+  _emitter.define_address (b->begin);
+  statements (b->statements);
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- if and do statements nest to any depth, so their guarded commands
+   are walked on a stack, _nested, rather than by recursing: entering 
+   one goes on to the first statement its first guard guards, and the 
+   end of a guarded command's statements comes back to it */
+void codegen::statements (list<ast::statement> const & l) {
+  size_t base = _nested.size ();
+  ast::statement const *s = l.first;
+  for (;;) {
+    if (s) {
+      if (node::if_statement == s->kind || node::do_statement == s->kind) {
+	s = enter (s);
+      } else {
+	statement (s);
+	s = s->next;
+      }
+    } else if (base == _nested.size ()) {
+      break;
+    } else {
+      s = leave ();
+    }
+  }
+}
+
+/* --------------------------------------------------------------------*/
+
+void codegen::statement (ast::statement const *s) {
+  switch (s->kind) {
+  case node::empty:
+    break;
+  case node::read: {
+    ast::read const *r = static_cast<ast::read const*> (s);
+    variables (r->variables);
+    _emitter.locate (r->offset);
+    _emitter.read (r->variables.count);
+    break;
+  }
+  case node::write: {
+    ast::write const *w = static_cast<ast::write const*> (s);
+    expressions (w->expressions);
+    _emitter.locate (w->offset);
+    _emitter.write (w->expressions.count);
+    break;
+  }
+  case node::assignment: {
+    assignment const *a = static_cast<assignment const*> (s);
+    variables (a->variables);
+    expressions (a->expressions);
+    if (a->variables.count == a->expressions.count) {
+      _emitter.locate (a->offset);
+      _emitter.assign (a->variables.count);
+    }
+    break;
+  }
+  case node::call: {
+    ast::call const *c = static_cast<ast::call const*> (s);
+    _emitter.locate (c->offset);
+    _emitter.call (c->level, c->label);
+    break;
+  }
+  default:
+    /* ERROR! - can't get here */
+    assert (0);
+    break;
+  }
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- start on an if or do statement: its first guard, whose statements
+   are the next to be generated */
+ast::statement const* codegen::enter (ast::statement const *s) {
+  nesting n = { s, NULL, 0 };
+  if (node::if_statement == s->kind) {
+    if_statement const *i = static_cast<if_statement const*> (s);
+    n.command = i->commands.first;
+    n.go_to   = i->done;
+  } else {
+    do_statement const *d = static_cast<do_statement const*> (s);
+    _emitter.locate (d->commands.first->start);
+    _emitter.define_address (d->loop);
+    n.command = d->commands.first;
+    n.go_to   = d->loop;
+  }
+  _nested.push_back (n);
+  return guard (n.command);
+}
+
+/* --------------------------------------------------------------------*/
+
+/* GuardedCommandList = GuardedCommand { "[]" GuardedCommand } . */
+/* GuardedCommand = Expression "->" StatementPart . */
+ast::statement const* codegen::guard (guarded_command const *g) {
+  _emitter.locate (g->start);
+  _emitter.define_address (g->entry);
+  expression (g->guard);
+  _emitter.locate (g->arrow);
+  _emitter.arrow (g->exit);
+  return g->statements.first;
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- the innermost guarded command's statements are done: on to the
+   next guard, or finish the statement and go on to the one after it */
+ast::statement const* codegen::leave () {
+  nesting & n = _nested.back ();
+  _emitter.locate (n.command->offset);
+  _emitter.bar (n.go_to);
+  if ((n.command = n.command->next)) {
+    return guard (n.command);
+  }
+  ast::statement const *s = n.statement;
+  _nested.pop_back ();
+  if (node::if_statement == s->kind) {
+    /* --- each guard that fails falls through to the next, and when
+       none holds the program stops (at the "fi" line) */
+    if_statement const *i = static_cast<if_statement const*> (s);
+    _emitter.locate (i->offset);
+    _emitter.define_address (i->commands.last->exit);
+    _emitter.fi (i->line);
+    _emitter.define_address (i->done);
+  } else {
+    /* --- a guard that holds loops back to the top, and the loop ends 
+       when none does */
+    do_statement const *d = static_cast<do_statement const*> (s);
+    _emitter.locate (d->offset);
+    _emitter.define_address (d->commands.last->exit);
+  }
+  return s->next;
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- variables as the targets of a read or an assignment: their
+   addresses */
+void codegen::variables (list<ast::expression> const & l) {
+  for (ast::expression const *e = l.first; e; e = e->next) {
+    variable (e);
+  }
+}
+
+/* --------------------------------------------------------------------*/
+
+/* VariableAccess = VariableName [ IndexedSelector ] . */
+void codegen::variable (ast::expression const *e) {
+  identifier const *v = static_cast<identifier const*> (e);
+  if (node::access == e->kind) {
+    access const *a = static_cast<access const*> (e);
+    _emitter.locate (a->selector);
+    _emitter.variable (a->level, a->displacement);
+    expression (a->index);
+    _emitter.locate (a->index->offset);
+    _emitter.index (a->upper, a->line);
+  } else {
+    _emitter.locate (v->offset);
+    _emitter.variable (v->level, v->displacement);
+  }
+}
+
+/* --------------------------------------------------------------------*/
+
+void codegen::expressions (list<ast::expression> const & l) {
+  for (ast::expression const *e = l.first; e; e = e->next) {
+    expression (e);
+  }
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- an expression's value: its operands' code, and then its own (an
+   element of an array has its address, its index, and the check of the
+   index in between).  The tree is walked on a stack of its own, so that
+   however deep an expression is nested, the native stack is not: down 
+   the left of each subtree to a leaf, and back up, finishing each node
+   on the way, until one has a right operand still to go down */
+void codegen::expression (ast::expression const *e) {
+  size_t base = _stack.size (), top = base;
+  for (;;) {
+    for (;;) {                  /* -- down to the leftmost leaf */
+      if (top == _stack.size ()) {
+	_stack.resize (2 * top + 16);
+      }
+      if (node::binary == e->kind) {
+	_stack[top++] = e;
+	e = static_cast<binary const*> (e)->left;
+      } else if (node::unary == e->kind) {
+	_stack[top++] = e;
+	e = static_cast<unary const*> (e)->operand;
+      } else if (node::access == e->kind) {
+	access const *a = static_cast<access const*> (e);
+	_emitter.locate (a->selector);
+	_emitter.variable (a->level, a->displacement);
+	_stack[top++] = e;
+	e = a->index;
+      } else {
+	break;
+      }
+    }
+    _emitter.locate (e->offset);
+    if (node::constant == e->kind) {
+      _emitter.constant (static_cast<constant const*> (e)->value);
+    } else {
+      variable (e);
+      _emitter.value ();
+    }
+    for (;;) {                  /* -- and up, to a right operand */
+      if (top == base) {
+	_stack.resize (base);
+	return;
+      }
+      ast::expression const *parent = _stack[top - 1];
+      if (node::binary == parent->kind 
+	  && e == static_cast<binary const*> (parent)->left) {
+	e = static_cast<binary const*> (parent)->right;
+	break;
+      }
+      e = parent;
+      --top;
+      finish (e);
+    }
+  }
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- the code for a node, once the code for its operands is done */
+void codegen::finish (ast::expression const *e) {
+  if (node::access == e->kind) {
+    access const *a = static_cast<access const*> (e);
+    _emitter.locate (a->index->offset);
+    _emitter.index (a->upper, a->line);
+    _emitter.locate (e->offset);
+    _emitter.value ();
+    return;
+  }
+  _emitter.locate (e->offset);
+  if (node::unary == e->kind) {
+    switch (e->op) {
+    case       MINUS: _emitter.minus (); break;
+    case LOGICAL_NOT: _emitter.not$ ();  break;
+    default:          assert (0);        break;
+    }
+    return;
+  }
+  switch (e->op) {
+  case  LOGICAL_AND: _emitter.and$ ();     break;
+  case   LOGICAL_OR: _emitter.or$ ();      break;
+  case GREATER_THAN: _emitter.greater ();  break;
+  case        EQUAL: _emitter.equal ();    break;
+  case    LESS_THAN: _emitter.less ();     break;
+  case         PLUS: _emitter.add ();      break;
+  case        MINUS: _emitter.subtract (); break;
+  case     MULTIPLY: _emitter.multiply (); break;
+  case       DIVIDE: _emitter.divide ();   break;
+  case       MODULO: _emitter.modulo ();   break;
+  default:           assert (0);           break;
+  }
+}
+
+/*----------------------------------------------------------------------
+  Emacs Configuration
+  Local Variables:
+  mode: C++
+  End:
+----------------------------------------------------------------------*/
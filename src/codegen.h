@@ -0,0 +1,64 @@
+/*----------------------------------------------------------------------
+  File    : codegen.h
+  Contents: Code generation from the abstract syntax tree
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#ifndef CODEGEN_H
+#define CODEGEN_H
+
+#include "ast.h"
+#include "emitter.h"
+#include <vector>
+
+/*----------------------------------------------------------------------
+  Main Class - walks a program's tree, depth first and in source order,
+  and hands the PL machine code for it to an emitter.  Any errors were
+  reported while the tree was built, so nothing here can fail.
+----------------------------------------------------------------------*/
+
+class codegen {
+
+private:
+
+  emitter_interface &_emitter;
+  std::vector<ast::expression const*> _stack; /* an expression's nodes 
+						 still to be finished */
+
+  /* --- an if or do statement being generated, and the guarded command
+     of it whose statements are */
+  struct nesting {
+    ast::statement const       *statement;
+    ast::guarded_command const *command;
+    int                         go_to;  /* where a command goes after */
+  };
+  std::vector<nesting> _nested;
+
+  void block (ast::block const*);
+  void statements (ast::list<ast::statement> const&);
+  void statement (ast::statement const*);
+  ast::statement const* enter (ast::statement const*);
+  ast::statement const* guard (ast::guarded_command const*);
+  ast::statement const* leave ();
+  void variables (ast::list<ast::expression> const&);
+  void variable (ast::expression const*);
+  void expressions (ast::list<ast::expression> const&);
+  void expression (ast::expression const*);
+  void finish (ast::expression const*);
+
+public:
+
+  explicit codegen (emitter_interface&);
+  void program (ast::program const*);
+
+};
+
+#endif
+
+/*----------------------------------------------------------------------
+  Emacs Configuration
+  Local Variables:
+  mode: C++
+  End:
+----------------------------------------------------------------------*/
@@ -12,12 +12,24 @@
 #include "compiler.h"
 #include "parser.h"
 #include "assembler.h"
+#include "cgen.h"
+#include "codegen.h"
+#include "gas.h"
+#include "heap.h"
+#include "interpreter.h"
+#include "jit.h"
+#include "misc.h"
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
 #include <iostream>
 #include <exception>
 #include <fstream>
 #include <iostream>
 #include <iomanip>
 #include <string>
+#include <thread>
+#include <unistd.h>
 
 /*----------------------------------------------------------------------
   Namespace Inclusions
@@ -32,7 +44,7 @@ using std::ofstream;
 using std::setw;
 using std::setfill;
 using std::string;
-using std::stringstream;
+using std::vector;
 
 namespace apperr = error::application;
 
@@ -44,6 +56,42 @@ namespace apperr = error::application;
   Constants
 ----------------------------------------------------------------------*/
 
+/* --- long options and the switches they stand for */
+static const struct {
+  const char *name;
+  char        code;
+} long_options[] = {
+  { "run",     'r' },
+  { "engine",  'e' },
+  { "target",  't' },
+  { "pretokenize", 'p' },
+  { "legacy-scanner", 'l' },
+  { "jobs",    'j' }
+};
+
+/* --- execution engines, by name */
+static const struct {
+  const char   *name;
+  engine::code  code;
+} engines[] = {
+  { "switch",   engine::switched },
+  { "threaded", engine::threaded },
+  { "jit",      engine::native }
+};
+
+/* --- output targets, by name */
+static const struct {
+  const char   *name;
+  target::code  code;
+} targets[] = {
+  { "vm",       target::vm },
+  { "asm",      target::mnemonics },
+  { "c",        target::c },
+  { "gas",      target::assembly },
+  { "image",    target::binary },
+  { "exe",      target::executable }
+};
+
 /*----------------------------------------------------------------------
   Helper Methods
 ----------------------------------------------------------------------*/
@@ -53,13 +101,24 @@ namespace apperr = error::application;
 ----------------------------------------------------------------------*/
 
 compiler::compiler (int argc, char *argv[]) 
-  : _sasm (stringstream::in | stringstream::out),
-    _parser (_fin, _symbols, *this, *this) {
+  : _fn_in (NULL), _fn_out (NULL), 
+    _parser (_source, _symbols, _nodes, *this), _verbose (false), 
+    _run (false), _engine (NULL), _target (NULL), _threads (NULL), 
+    _gas (NULL),
+    _error_count (0), _cout_buffer (NULL) {
   parse (argc, argv);
 }
 
 /*--------------------------------------------------------------------*/
 
+compiler::~compiler () {
+  if (_cout_buffer) {           /* -- give stdout its own buffer back */
+    cout.rdbuf (_cout_buffer);  /* before the output file goes away */
+  }
+}
+
+/*--------------------------------------------------------------------*/
+
 void compiler::parse (int argc, char *argv[]) {
   int    k = 0;                 /* counter */
   char   *s;                    /* to traverse the options */
@@ -70,9 +129,18 @@ void compiler::parse (int argc, char *argv[]) {
     s = argv[i];                /* get option argument */
     if (optarg) { *optarg = s; optarg = NULL; continue; }
     if ('-' == *s && *++s) {  /* -- if argument is an option */
+      if ('-' == *s) {        /* long options are rewritten as */
+	s = short_option (++s); /* their single letter switch */
+      }
       while (*s) {            /* traverse options */
         switch (*s++) {       /* evaluate switches */
         case 'v': _verbose = true;               break;
+        case 'r': _run     = true;               break;
+        case 'e': _run     = true; optarg = &_engine; break;
+        case 't': optarg   = &_target;           break;
+        case 'p': _parser.pretokenize (true);    break;
+        case 'l': _parser.legacy_scanner (true); break;
+        case 'j': optarg   = &_threads;          break;
         default : 
 	  error (apperr::unknown_option, *--s); break;
         }                       /* set option variables */
@@ -87,18 +155,42 @@ void compiler::parse (int argc, char *argv[]) {
     }
   } 
 
+  /* --- an engine given by name must be one we have --- */
+  if (_engine) {
+    engine ();
+  }
+
+  /* --- tokenizing on several threads (as many as there are cores,
+     for 0) means tokenizing up front --- */
+  if (_threads) {
+    char *end;
+    long  n = strtol (_threads, &end, 10);
+    if (end == _threads || *end || n < 0 || n > 256) {
+      error (apperr::threads, _threads);
+    }
+    if (0 == n) {
+      n = std::thread::hardware_concurrency ();
+    }
+    _parser.pretokenize (true);
+    _parser.lex_threads (n > 0 ? n : 1);
+  }
+
+  /* --- so must a target; an executable needs somewhere to go --- */
+  if (target::executable == target () && !_run && !_fn_out) {
+    error (apperr::no_dest_file);
+  }
+
   /* --- open source file --- */
   if (_fn_in) {
-    _fin.open (_fn_in, ifstream::in);
-    if (!_fin.good ()) {
+    if (!_source.open (_fn_in)) {
       error (apperr::file_open, _fn_in);
     }
   } else {
     error (apperr::no_source_file, _fn_in);
   }
 
-  /* --- open output file --- */
-  if (_fn_out) {
+  /* --- open output file (the C compiler writes executables) --- */
+  if (_fn_out && (_run || target::executable != target ())) {
     _fout.open (_fn_out, ofstream::out);
     if (!_fout.good ()) {
       error (apperr::file_open, _fn_out);
@@ -106,33 +198,317 @@ void compiler::parse (int argc, char *argv[]) {
     /* this is a cute little STL trick: if there is a output file, 
        redirect the stdout to it. */
     _fout.copyfmt (cout);     /* copy all format information */  
-    cout.rdbuf (_fout.rdbuf ());
+    _cout_buffer = cout.rdbuf (_fout.rdbuf ());
   }       
 
 }
 
 /*--------------------------------------------------------------------*/
 
+/* --- map a long option (without its leading "--") to the switch it
+   stands for; a value given as --name=value follows the switch, just
+   as it would if it were written -xvalue */
+char* compiler::short_option (char *s) {
+  char  *v = strchr (s, '=');
+  size_t n = v ? static_cast<size_t> (v - s) : strlen (s);
+  for (unsigned int i = 0; i < count_of (long_options); ++i) {
+    if (strlen (long_options[i].name) == n 
+	&& 0 == strncmp (long_options[i].name, s, n)) {
+      _option = long_options[i].code;
+      if (v) { _option += v + 1; }
+      return &_option[0];
+    }
+  }
+  error (apperr::unknown_long, s);
+  return s;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* --- returns true if the engine can run on this machine */
+static bool available (engine::code e) {
+  switch (e) {
+  case engine::switched: return true;
+  case engine::threaded: return interpreter::supported (dispatch::threaded);
+  case engine::native:   return jit::supported ();
+  }
+  return false;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* --- the execution engine named on the command-line (the threaded 
+   interpreter, or the switch based one, by default) */
+engine::code compiler::engine () const {
+  if (!_engine) {
+    return available (engine::threaded) 
+      ? engine::threaded : engine::switched;
+  }
+  for (unsigned int i = 0; i < count_of (engines); ++i) {
+    if (0 == strcmp (engines[i].name, _engine)
+	&& available (engines[i].code)) {
+      return engines[i].code;
+    }
+  }
+  error (apperr::unknown_engine, _engine);
+  return engine::switched;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* --- run an assembled program with the selected engine */
+int compiler::execute (int const * code, size_t words) {
+  engine::code e = engine ();
+  if (engine::native == e) {
+    jit native (code, words, *this, cin, cout);
+    return native.run ();
+  }
+  interpreter vm (code, words, *this, cin, cout, engine::threaded == e 
+		  ? dispatch::threaded : dispatch::switched);
+  return vm.run ();
+}
+
+/*--------------------------------------------------------------------*/
+
+/* --- as execute, but reports the run time when verbose */
+int compiler::run (int const * code, size_t words) {
+  clock_t start  = clock ();
+  int     status = execute (code, words);
+  if (_verbose) {
+    cerr << _fn_in << ": ran in "
+	 << static_cast<double> (clock () - start) / CLOCKS_PER_SEC
+	 << "s\n";
+  }
+  cout.flush ();
+  return status;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* --- run a program image, straight from the mapped file */
+int compiler::run_image () {
+  image::program program;
+  if (!program.load (_fn_in)) {
+    error (apperr::bad_image, _fn_in);
+  }
+  if (!_run) {
+    error (apperr::image, _fn_in);
+  }
+  return run (program.code (), program.words ());
+}
+
+/*--------------------------------------------------------------------*/
+
+/* --- assemble the intermediate code in to memory, noting where each
+   source line's code starts if asked to */
+void compiler::assemble (vector<int> & code, vector<image::line> * lines) {
+  Assembler assembler (code);
+  for (size_t i = 0; i < _ir.size (); ++i) {
+    int number = lines ? _source.line (_offsets[i]) : 0;
+    if (lines && (lines->empty () || lines->back ().number != number)) {
+      image::line l = { static_cast<int> (assembler.size ()), number };
+      if (!lines->empty () && lines->back ().address == l.address) {
+	lines->back () = l;     /* (the previous line has no code) */
+      } else {
+	lines->push_back (l);
+      }
+    }
+    assembler.instruction (_ir[i]);
+  }
+  assembler.finish ();
+}
+
+/*--------------------------------------------------------------------*/
+
+/* --- the output target named on the command-line (PL machine code,
+   by default) */
+target::code compiler::target () const {
+  if (!_target) {
+    return target::vm;
+  }
+  for (unsigned int i = 0; i < count_of (targets); ++i) {
+    if (0 == strcmp (targets[i].name, _target)) {
+      return targets[i].code;
+    }
+  }
+  error (apperr::unknown_target, _target);
+  return target::vm;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* --- write an assembled program out as C */
+int compiler::translate (vector<int> const & code) {
+  cgen translator (code, *this, _fn_in);
+  return translator.write (cout) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* --- build an assembled program in to an executable, by writing it
+   out as C and handing that to the system's C compiler ($CC, or cc) */
+int compiler::build (vector<int> const & code) {
+  char        tmp[] = "/tmp/plcXXXXXX";
+  const char *cc    = getenv ("CC");
+  string      command, out (_fn_out);
+  int         fd    = mkstemp (tmp);
+  if (-1 == fd) {
+    error (apperr::file_open, tmp);
+  }
+  close (fd);
+
+  /* --- translate in to the temporary file --- */
+  ofstream    fc (tmp, ofstream::out);
+  cgen        translator (code, *this, _fn_in);
+  if (!translator.write (fc)) {
+    fc.close (); unlink (tmp);
+    return EXIT_FAILURE;
+  }
+  fc.close ();
+  if (!fc) {
+    unlink (tmp);
+    error (apperr::file_write, tmp);
+  }
+
+  /* --- compile it (quoting the output name for the shell) --- */
+  for (string::size_type i = 0; (i = out.find ('\'', i)) != string::npos;
+       i += 4) {
+    out.replace (i, 1, "'\\''");
+  }
+  command = string (cc && *cc ? cc : "cc") + " -O2 -x c -o '" + out 
+    + "' " + tmp;
+  if (_verbose) {
+    cerr << command << '\n';
+  }
+  int status = system (command.c_str ());
+  unlink (tmp);
+  if (0 != status) {
+    error (apperr::command, command.c_str ());
+  }
+  return EXIT_SUCCESS;
+}
+
+
+/*--------------------------------------------------------------------*/
+
+/* --- write the intermediate code as assembly source, which plasm
+   reads */
+void compiler::list (std::ostream & out) const {
+  for (ir::code::const_iterator it = _ir.begin (); it != _ir.end (); ++it) {
+    out << ir::name (it->op);
+    switch (ir::operands (it->op)) {
+    case 2: out << ' ' << it->x << ' ' << it->y; break;
+    case 1: out << ' ' << it->x;                 break;
+    }
+    out << '\n';
+  }
+}
+
+/*--------------------------------------------------------------------*/
+
 int compiler::compile () {
+  int status = EXIT_SUCCESS;
     
   try {
+
+    /* --- a program image is run as it is --- */
+    if (image::is_image (_fn_in)) {
+      _source.close ();
+      status = run_image ();
+      _fout.close ();
+      return status;
+    }
+
+    /* --- assembly is written as the parser emits it --- */
+    gas assembly (cout, _fn_in);
+    if (!_run && target::assembly == target ()) {
+      _gas = &assembly;
+      _gas->prologue ();
+    }
   
-    /* --- parse the PL source --- */  
-    _parser.parse ();           
-    _fin.close ();              /* close the PL source file */
-
-    /* --- assemble the source --- */
-    Assembler assembler (_sasm, cout);
-    assembler.firstPass (); 
-    _sasm.seekg (stringstream::beg); 
-    assembler.secondPass ();
+    /* --- parse the PL source in to a syntax tree, and generate the
+       code from that (freeing the whole tree at once afterwards) --- */  
+#ifdef HEAP_COUNT
+    unsigned long allocations = heap::allocations ();
+#endif
+    ast::program *tree = _parser.parse ();
+    if (_verbose) {
+      cerr << _fn_in << ": parsed " << _parser.statements () << " statements";
+#ifdef HEAP_COUNT
+      cerr << " with " << heap::allocations () - allocations 
+	   << " heap allocations";
+#endif
+      cerr << '\n';
+    }
+    codegen (*this).program (tree);
+    _nodes.release ();
+    if (_gas || _run || target::binary != target ()) {
+      _source.close ();         /* release the PL source text (an image's */
+    }                           /* line table is still to be found in it) */
+
+    if (_gas) {
+
+      /* --- finish off the assembly source --- */
+      _gas->epilogue ();
+      _gas = NULL;
+      if (_error_count) {
+	status = EXIT_FAILURE;
+      }
+      cout.flush ();
+
+    } else if (_run) {
+      
+      /* --- assemble in to memory and run the program, but only if
+	 it compiled cleanly --- */
+      vector<int> code;
+      assemble (code);
+      if (_error_count) {
+	status = EXIT_FAILURE;
+      } else {
+	status = run (&code[0], code.size ());
+      }
+      cout.flush ();
+
+    } else if (target::mnemonics == target ()) {
+
+      /* --- list the intermediate code --- */
+      list (cout);
+      cout.flush ();
+
+    } else if (target::vm != target ()) {
+
+      /* --- assemble in to memory, and write it out as an image or
+	 translate it to C --- */
+      vector<int>         code;
+      vector<image::line> lines;
+      assemble (code, target::binary == target () ? &lines : NULL);
+      if (_error_count) {
+	status = EXIT_FAILURE;
+      } else if (target::binary == target ()) {
+	if (!image::write (cout, code, lines)) {
+	  error (apperr::file_write, _fn_out ? _fn_out : "stdout");
+	}
+      } else if (target::c == target ()) {
+	status = translate (code);
+      } else {
+	status = build (code);
+      }
+      cout.flush ();
+
+    } else {
+
+      /* --- assemble the source --- */
+      Assembler assembler (cout);
+      assembler.assemble (_ir);
+
+    }
     _fout.close ();
    
   } catch (exception & e) {   /* -- all fatals */
     cerr << "error: " << e.what () << '\n';
   }
   
-  return 0;
+  return status;
   
 }
 
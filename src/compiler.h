@@ -8,18 +8,53 @@
 #ifndef COMPILER_H
 #define COMPILER_H
 
+#include "arena.h"
+#include "assembler.h"
 #include "error.h"
 #include "emitter.h"
+#include "interpreter.h"
+#include "image.h"
+#include "ir.h"
 #include "parser.h"
+#include "source.h"
 #include "symboltbl.h"
 #include <exception>
 #include <fstream>
-#include <sstream>
 #include <string>
+#include <vector>
+
+ /*----------------------------------------------------------------------
+  Engine Codes - the ways a program can be run in-process
+----------------------------------------------------------------------*/
+
+namespace engine {
+  enum code {
+    switched,                   /* interpreter, switch dispatch */
+    threaded,                   /* interpreter, direct threading */
+    native                      /* x86-64 template JIT */
+  };
+}
+
+/*----------------------------------------------------------------------
+  Target Codes - what the compiler writes, when not running a program
+----------------------------------------------------------------------*/
+
+namespace target {
+  enum code {
+    vm,                         /* PL machine code */
+    mnemonics,                  /* PL machine assembly, for plasm */
+    c,                          /* C source */
+    assembly,                   /* x86-64 GNU assembler source */
+    executable,                 /* native executable, via the C compiler */
+    binary                      /* mmap-able program image */
+  };
+}
 
 /*----------------------------------------------------------------------
   Forward Declarations
 ----------------------------------------------------------------------*/
+
+class gas;
  
 /*----------------------------------------------------------------------
   Main Class
@@ -31,25 +66,47 @@ class compiler : public error_interface, public emitter_interface {
 
   char             *_fn_in;      /* input file-name */
   char             *_fn_out;     /* output file-name */
-  std::ifstream     _fin;        /* input file stream */  
-  std::stringstream _sasm;       /* asm stream */
+  source            _source;     /* PL source text */
+  ir::code          _ir;         /* intermediate code */
+  std::vector<unsigned> _offsets; /* source offset of each instruction */
   std::ofstream     _fout;       /* final output file stream */
   symboltbl         _symbols;    /* main symbol table */
+  arena             _nodes;      /* the syntax tree's memory */
   parser            _parser;     /* PL language parser */
   bool              _verbose;    /* noisy output */
+  bool              _run;        /* execute instead of writing code */
+  char             *_engine;     /* name of the execution engine */
+  char             *_target;     /* name of the output target */
+  char             *_threads;    /* threads to tokenize on */
+  gas              *_gas;        /* assembly emitter, if writing gas */
+  std::string       _option;     /* long option translated to a switch */
+  mutable int       _error_count; /* number of input errors reported */
+  std::streambuf   *_cout_buffer; /* stdout's own buffer, when redirected */
   
   void parse (int, char*[]);
+  char* short_option (char*);
+  engine::code engine () const;
+  void assemble (std::vector<int>&, std::vector<image::line>* = NULL);
+  int execute (int const*, size_t);
+  int run (int const*, size_t);
+  int run_image ();
+  target::code target () const;
+  int translate (std::vector<int> const&);
+  int build (std::vector<int> const&);
+  void list (std::ostream&) const;
 
   void error (error::application::code, ...) const;
   void error (error::input::code, ...) const;
+  void error (error::runtime::code, ...) const;
   
-  void emit (std::string const&);  
-  void emit (std::string const&, int);  
-  void emit (std::string const&, int , int);  
+  void emit (int);  
+  void emit (int, int);  
+  void emit (int, int , int);  
     
  public:
   
   compiler (int, char*[]);
+  ~compiler ();
   int compile ();
 
 };
@@ -11,15 +11,14 @@
 
 #include "emitter.h"
 #include "compiler.h"
-#include <iostream>
-#include <string>
+#include "gas.h"
+#include "ir.h"
+#include "opcode.h"
 
 /*----------------------------------------------------------------------
   Namespace Inclusions
 ----------------------------------------------------------------------*/
 
-using std::cout;
-using std::string;
 
 /*----------------------------------------------------------------------
   Preprocessor Definitions
@@ -33,203 +32,221 @@ using std::string;
   Emitter Methods
 ----------------------------------------------------------------------*/
 
+emitter_interface::emitter_interface () 
+  : _at (0) {
+}
+
+/*--------------------------------------------------------------------*/
+
 emitter_interface::~emitter_interface () {
 }
 
 /*--------------------------------------------------------------------*/
 
+void emitter_interface::locate (unsigned int offset) {
+  _at = offset;
+}
+
+/*--------------------------------------------------------------------*/
+
 void emitter_interface::add () {
-  emit ("ADD");
+  emit (opcode::add);
 }
 
 /*--------------------------------------------------------------------*/
 
 void emitter_interface::and$ () {
-  emit ("AND");
+  emit (opcode::and$);
 }
  
 /*--------------------------------------------------------------------*/
 
 void emitter_interface::arrow (int a) {
-  emit ("ARROW", a);
+  emit (opcode::arrow, a);
 }
  
 /*--------------------------------------------------------------------*/
 
 void emitter_interface::assign (int n) {
-  emit ("ASSIGN", n);
+  emit (opcode::assign, n);
 }
  
 /*--------------------------------------------------------------------*/
 
 void emitter_interface::bar (int a) {
-  emit ("BAR", a);
+  emit (opcode::bar, a);
 }
  
 /*--------------------------------------------------------------------*/
 
 void emitter_interface::call (int l, int a) {
-  emit ("CALL", l, a);
+  emit (opcode::call, l, a);
 }
  
 /*--------------------------------------------------------------------*/
 
 void emitter_interface::constant (int v) {
-  emit ("CONSTANT", v);
+  emit (opcode::constant, v);
 }
 
 /*--------------------------------------------------------------------*/
 
 void emitter_interface::divide () {
-  emit ("DIVIDE");
+  emit (opcode::divide);
 }
  
 /*--------------------------------------------------------------------*/
 
 void emitter_interface::end_procedure () {
-  emit ("ENDPROC");
+  emit (opcode::end_procedure);
 }
  
 /*--------------------------------------------------------------------*/
 
 void emitter_interface::end_program () {
-  emit ("ENDPROG");
+  emit (opcode::end_program);
 }
  
 /*--------------------------------------------------------------------*/
 
 void emitter_interface::equal () {
-  emit ("EQUAL");
+  emit (opcode::equal);
 }
  
 /*--------------------------------------------------------------------*/
 
 void emitter_interface::fi (int n) {
-  emit ("FI", n);
+  emit (opcode::fi, n);
 }
 
 /*--------------------------------------------------------------------*/
 
 void emitter_interface::greater () {
-  emit ("GREATER");
+  emit (opcode::greater);
 }
 
 /*--------------------------------------------------------------------*/
 
 void emitter_interface::index (int u, int n) {
-  emit ("INDEX", u, n);
+  emit (opcode::index, u, n);
 }
 
 /*--------------------------------------------------------------------*/
 
 void emitter_interface::less () {
-  emit ("LESS");
+  emit (opcode::less);
 }
  
 /*--------------------------------------------------------------------*/
 
 void emitter_interface::minus () {
-  emit ("MINUS");
+  emit (opcode::minus);
 }
  
 /*--------------------------------------------------------------------*/
 
 void emitter_interface::modulo () {
-  emit ("MODULO");
+  emit (opcode::modulo);
 }
  
 /*--------------------------------------------------------------------*/
 
 void emitter_interface::multiply () {
-  emit ("MULTIPLY");
+  emit (opcode::multiply);
 }
  
 /*--------------------------------------------------------------------*/
 
 void emitter_interface::not$ () {
-  emit ("NOT");
+  emit (opcode::not$);
 }
 
 /*--------------------------------------------------------------------*/
 
 void emitter_interface::or$ () {
-  emit ("OR");
+  emit (opcode::or$);
 }
  
 /*--------------------------------------------------------------------*/
 
 void emitter_interface::procedure (int l, int a) {
-  emit ("PROC", l, a);
+  emit (opcode::procedure, l, a);
 }
  
 /*--------------------------------------------------------------------*/
 
 void emitter_interface::program (int l, int a) {
-  emit ("PROG", l, a);
+  emit (opcode::program, l, a);
 }
  
 /*--------------------------------------------------------------------*/
 
 void emitter_interface::read (int n) {
-  emit ("READ", n);
+  emit (opcode::read, n);
 }
  
 /*--------------------------------------------------------------------*/
 
 void emitter_interface::subtract () {
-  emit ("SUBTRACT");
+  emit (opcode::subtract);
 }
 
 /*--------------------------------------------------------------------*/
  
 void emitter_interface::value () {
-  emit ("VALUE");
+  emit (opcode::value);
 }
 
 /*--------------------------------------------------------------------*/
 
 void emitter_interface::variable (int l, int d) {
-  emit ("VARIABLE", l, d);
+  emit (opcode::variable, l, d);
 }
  
 /*--------------------------------------------------------------------*/
 
 void emitter_interface::write (int n) {
-  emit ("WRITE", n);
+  emit (opcode::write, n);
 }
 
 /*--------------------------------------------------------------------*/
 
 void emitter_interface::define_address (int a) {
-  emit ("DEFADDR", a);
+  emit (ir::define_address, a);
 }
 
 /*--------------------------------------------------------------------*/
 
 void emitter_interface::define_argument (int a, int l) {
-  emit ("DEFARG", a, l);
+  emit (ir::define_argument, a, l);
 }
 
 /*----------------------------------------------------------------------
-  Compiler Methods
+  Compiler Methods - append each instruction to the intermediate code
+  (or pass it on, when writing assembly)
 ----------------------------------------------------------------------*/
 
-void compiler::emit (string const &op) {
-  // cout << op << "\n";
-  _sasm << op << "\n";
+void compiler::emit (int op) {
+  if (_gas) { _gas->emit (op); return; }
+  ir::instruction i = { op, 0, 0 };
+  _ir.push_back (i);
+  _offsets.push_back (_at);
 }
 
 /*--------------------------------------------------------------------*/
 
-void compiler::emit (string const &op, int x) {
-  // cout << op << " " << x << "\n";
-  _sasm << op << " " << x << "\n";
+void compiler::emit (int op, int x) {
+  if (_gas) { _gas->emit (op, x); return; }
+  ir::instruction i = { op, x, 0 };
+  _ir.push_back (i);
+  _offsets.push_back (_at);
 }
 
 /*--------------------------------------------------------------------*/
 
-void compiler::emit (string const &op, int x, int y) {
-  // cout << op << " " << x << " " << y << "\n";
-  _sasm << op << " " << x << " " << y << "\n";
+void compiler::emit (int op, int x, int y) {
+  if (_gas) { _gas->emit (op, x, y); return; }
+  ir::instruction i = { op, x, y };
+  _ir.push_back (i);
+  _offsets.push_back (_at);
 }
-
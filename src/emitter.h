@@ -8,8 +8,6 @@
 #ifndef EMITTER_H
 #define EMITTER_H
 
-#include <string>
-
 /*----------------------------------------------------------------------
   Forward Declarations
 ----------------------------------------------------------------------*/
@@ -23,15 +21,21 @@ class label;
 struct emitter_interface {
 
 protected:
+
+  unsigned int _at;             /* source offset of the code emitted */
   
-  virtual void emit (std::string const&) = 0;  
-  virtual void emit (std::string const&, int) = 0;  
-  virtual void emit (std::string const&, int , int) = 0;  
+  /* --- the operation is an opcode::code, or an ir::pseudo */
+  virtual void emit (int) = 0;  
+  virtual void emit (int, int) = 0;  
+  virtual void emit (int, int , int) = 0;  
 
 public:
 
+  emitter_interface ();
   virtual ~emitter_interface ();
 
+  void locate (unsigned int);   /* where the next code comes from */
+
   void add (); 
   void and$ (); 
   void arrow (int); 
@@ -43,7 +43,14 @@ static const char *_fatal_messages[] = {
   /*  -6 */  "no destination file supplied\n",
   /*  -7 */  "unknown option -%c\n",
   /*  -8 */  "wrong number of arguments\n",
-  /*  -9 */  "unknown error\n",
+  /*  -9 */  "unknown option --%s\n",
+  /* -10 */  "unknown or unavailable execution engine %s\n",
+  /* -11 */  "unknown output target %s\n",
+  /* -12 */  "command failed: %s\n",
+  /* -13 */  "%s is a program image, which can only be run (--run)\n",
+  /* -14 */  "invalid number of threads %s\n",
+  /* -15 */  "%s is not a valid program image\n",
+  /* -16 */  "unknown error\n",
 };  
 
 static const char *_input_messages[] = {
@@ -63,10 +70,30 @@ static const char *_input_messages[] = {
   /* -13 */  "unknown error\n",
 };
 
+static const char *_runtime_messages[] = {
+  /*   0 */  "no error\n",
+  /*  -1 */  "stack overflow\n",
+  /*  -2 */  "line %d: index out of bounds\n",
+  /*  -3 */  "line %d: if statement fails\n",
+  /*  -4 */  "division by zero\n",
+  /*  -5 */  "integer expected on input\n",
+  /*  -6 */  "invalid instruction %d at address %d\n",
+  /*  -7 */  "unknown error\n",
+};
+
 /*----------------------------------------------------------------------
   Functions
 ----------------------------------------------------------------------*/
 
+const char* error::runtime::message (error::runtime::code code)
+{                               /* --- get a runtime error message */
+  if (code > 0 || code < error::runtime::unknown) {
+    code = error::runtime::unknown; }
+  return _runtime_messages[-code];
+}
+
+/* --------------------------------------------------------------------*/
+
 void compiler::error (error::application::code code, ...) const
 {                               /* --- print an error message and quit */
   va_list     args;             /* list of variable arguments */
@@ -94,6 +121,8 @@ void compiler::error (error::input::code code, ...) const
     code = error::input::unknown; }
   if (code < 0) {             /* if to report an error, */
     msg = _input_messages[-code]; /* get the error message */
+    if (error::input::did_you_mean != code) {
+      _error_count++; }       /* (suggestions are not errors) */
     if (!msg) { msg = _input_messages[-error::input::unknown]; }
     fprintf (stderr, "%s:%d: error: ", _fn_in, _parser.line ());
     va_start (args, code);    /* get variable arguments */
@@ -101,3 +130,21 @@ void compiler::error (error::input::code code, ...) const
     va_end (args);            /* end argument evaluation */ 
   } 
 } 
+
+/* --------------------------------------------------------------------*/
+
+void compiler::error (error::runtime::code code, ...) const
+{                               /* --- print a runtime error message */
+  va_list     args;             /* list of variable arguments */
+  const char *msg;              /* error message */
+  if (code < error::runtime::unknown) {
+    code = error::runtime::unknown; }
+  if (code < 0) {             /* if to report an error, */
+    msg = error::runtime::message (code); /* get the error message */
+    std::cout.flush ();         /* keep the program's output in order */
+    fprintf (stderr, "%s: runtime error: ", _fn_in);
+    va_start (args, code);    /* get variable arguments */
+    vfprintf (stderr, msg, args); /* print error message */
+    va_end (args);            /* end argument evaluation */
+  }
+}
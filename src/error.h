@@ -26,7 +26,14 @@ namespace error {
       no_dest_file   =  -6,     /* no dest file */
       unknown_option =  -7,     /* unknown option */    
       argument_count =  -8,     /* too few/many arguments */
-      unknown        =  -9      /* unknown error */
+      unknown_long   =  -9,     /* unknown long option */
+      unknown_engine = -10,     /* unknown execution engine */
+      unknown_target = -11,     /* unknown output target */
+      command        = -12,     /* external command failed */
+      image          = -13,     /* program image given, but not run */
+      threads        = -14,     /* bad number of threads */
+      bad_image      = -15,     /* program image that cannot be run */
+      unknown        = -16      /* unknown error */
     };
   }
 }
@@ -59,6 +66,29 @@ namespace error {
   }
 }
 
+/*----------------------------------------------------------------------
+  Runtime error codes
+----------------------------------------------------------------------*/
+
+namespace error {
+  namespace runtime {
+    enum code {
+      none             =   0,   /* no error */
+      stack_overflow   =  -1,   /* out of stack space */
+      range            =  -2,   /* index out of bounds */
+      if_fails         =  -3,   /* no guard in an if statement held */
+      divide_by_zero   =  -4,   /* division (or modulo) by zero */
+      input            =  -5,   /* could not read an integer */
+      instruction      =  -6,   /* invalid machine instruction */
+      unknown          =  -7    /* unknown error */
+    };
+
+    /* -- the message (a printf format) for a runtime error; for the
+       programs we translate, which report their own errors */
+    const char* message (code);
+  }
+}
+
 #if 0
 enum error_code {
   E_NONE    =  0,               /* no error */
@@ -90,6 +120,7 @@ struct error_interface {
   
   virtual void error (error::application::code, ...) const = 0;
   virtual void error (error::input::code, ...) const = 0;  
+  virtual void error (error::runtime::code, ...) const = 0;
 
 };
 
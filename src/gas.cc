@@ -0,0 +1,555 @@
+/*----------------------------------------------------------------------
+  File    : gas.cc
+  Contents: PL machine to x86-64 GNU assembler emitter
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "gas.h"
+#include "error.h"
+#include "interpreter.h"
+#include "ir.h"
+#include "misc.h"
+#include "opcode.h"
+#include <iostream>
+#include <string>
+
+/*----------------------------------------------------------------------
+  Namespace Inclusions
+----------------------------------------------------------------------*/
+
+using std::endl;
+using std::ostream;
+using std::string;
+
+namespace rterr = error::runtime;
+
+/*----------------------------------------------------------------------
+  Preprocessor Definitions
+----------------------------------------------------------------------*/
+
+/* --- size of the input and output buffers */
+#define BUFFER_SIZE 4096
+
+/*----------------------------------------------------------------------
+  Register Usage - as the JIT's:
+
+    rbx   address of the stack (st[0])
+    r12   address of the top word (&st[s])
+    r13   base register b (a word index)
+    r15   address of the highest usable stack word
+
+  The links on the stack are words, so a return address is stored as
+  the low 32 bits of the return label's address; this is why the
+  program must be linked without -pie.
+----------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------
+  Constants
+----------------------------------------------------------------------*/
+
+/* --- runtime errors the generated code can report, with the names of
+   their handlers (each takes its argument, if any, in esi) */
+static const struct {
+  rterr::code  code;
+  const char  *name;
+} failures[] = {
+  { rterr::stack_overflow, "plc_overflow" },
+  { rterr::range,          "plc_range" },
+  { rterr::if_fails,       "plc_if_fails" },
+  { rterr::divide_by_zero, "plc_divide_by_zero" },
+  { rterr::input,          "plc_input" }
+};
+
+/* --- the run-time support: buffered, integer only, I/O using system
+   calls, and a clean exit */
+static const char *runtime[] = {
+  "# --- print eax in decimal; returns the digits in rsi, rdx",
+  "plc_itoa:",
+  "\tlea plc_digits+16(%rip), %rsi",
+  "\tmov %eax, %r8d",
+  "\ttest %eax, %eax",
+  "\tjns 1f",
+  "\tneg %eax",
+  "1:\tmov $10, %ecx",
+  "2:\txor %edx, %edx",
+  "\tdiv %ecx",
+  "\tadd $48, %dl",
+  "\tdec %rsi",
+  "\tmov %dl, (%rsi)",
+  "\ttest %eax, %eax",
+  "\tjnz 2b",
+  "\ttest %r8d, %r8d",
+  "\tjns 3f",
+  "\tdec %rsi",
+  "\tmovb $45, (%rsi)",
+  "3:\tlea plc_digits+16(%rip), %rdx",
+  "\tsub %rsi, %rdx",
+  "\tret",
+  "",
+  "# --- write rdx bytes at rsi to file edi",
+  "plc_put:",
+  "1:\ttest %rdx, %rdx",
+  "\tjz 2f",
+  "\tmov $1, %eax",
+  "\tpush %rdi",
+  "\tsyscall",
+  "\tpop %rdi",
+  "\ttest %rax, %rax",
+  "\tjle 2f",
+  "\tadd %rax, %rsi",
+  "\tsub %rax, %rdx",
+  "\tjmp 1b",
+  "2:\tret",
+  "",
+  "# --- empty the output buffer",
+  "plc_flush:",
+  "\tmov $1, %edi",
+  "\tlea plc_output(%rip), %rsi",
+  "\tmov plc_output_length(%rip), %rdx",
+  "\tcall plc_put",
+  "\tmovq $0, plc_output_length(%rip)",
+  "\tret",
+  "",
+  "# --- WRITE one word: eax, followed by a new line",
+  "plc_write:",
+  "\tcall plc_itoa",
+  "\tmov plc_output_length(%rip), %rdi",
+  "\tcmp $plc_buffer_size - 16, %rdi",
+  "\tjbe 1f",
+  "\tpush %rsi",
+  "\tpush %rdx",
+  "\tcall plc_flush",
+  "\tpop %rdx",
+  "\tpop %rsi",
+  "\txor %edi, %edi",
+  "1:\tlea plc_output(%rip), %rcx",
+  "2:\tmov (%rsi), %al",
+  "\tmov %al, (%rcx,%rdi)",
+  "\tinc %rsi",
+  "\tinc %rdi",
+  "\tdec %rdx",
+  "\tjnz 2b",
+  "\tmovb $10, (%rcx,%rdi)",
+  "\tinc %rdi",
+  "\tmov %rdi, plc_output_length(%rip)",
+  "\tret",
+  "",
+  "# --- the next input character in eax, or -1 at the end of the",
+  "# input; the output is flushed before the program waits for input",
+  "plc_getc:",
+  "\tmov plc_input_next(%rip), %rcx",
+  "\tcmp plc_input_length(%rip), %rcx",
+  "\tjb 1f",
+  "\tcall plc_flush",
+  "\txor %eax, %eax",
+  "\txor %edi, %edi",
+  "\tlea plc_input_buffer(%rip), %rsi",
+  "\tmov $plc_buffer_size, %edx",
+  "\tsyscall",
+  "\ttest %rax, %rax",
+  "\tjle 2f",
+  "\tmov %rax, plc_input_length(%rip)",
+  "\txor %ecx, %ecx",
+  "1:\tlea plc_input_buffer(%rip), %rsi",
+  "\tmovzbl (%rsi,%rcx), %eax",
+  "\tinc %rcx",
+  "\tmov %rcx, plc_input_next(%rip)",
+  "\tret",
+  "2:\tmovq $0, plc_input_length(%rip)",
+  "\tmovq $0, plc_input_next(%rip)",
+  "\tmov $-1, %eax",
+  "\tret",
+  "",
+  "# --- READ one word in to eax: an optionally signed decimal integer,",
+  "# after any white space",
+  "plc_read:",
+  "1:\tcall plc_getc",
+  "\tcmp $32, %eax",
+  "\tje 1b",
+  "\tcmp $9, %eax",
+  "\tjb 2f",
+  "\tcmp $13, %eax",
+  "\tjbe 1b",
+  "2:\txor %r9d, %r9d",
+  "\tcmp $45, %eax",
+  "\tjne 3f",
+  "\tinc %r9d",
+  "\tjmp 4f",
+  "3:\tcmp $43, %eax",
+  "\tjne 5f",
+  "4:\tcall plc_getc",
+  "5:\txor %r8d, %r8d",
+  "\txor %r10d, %r10d",
+  "6:\tsub $48, %eax",
+  "\tcmp $9, %eax",
+  "\tja 7f",
+  "\timul $10, %r8d, %r8d",
+  "\tadd %eax, %r8d",
+  "\tinc %r10d",
+  "\tcall plc_getc",
+  "\tjmp 6b",
+  "7:\tcmp $-1 - 48, %eax",
+  "\tje 8f",
+  "\tdecq plc_input_next(%rip)",
+  "8:\ttest %r10d, %r10d",
+  "\tjz plc_input",
+  "\tmov %r8d, %eax",
+  "\ttest %r9d, %r9d",
+  "\tjz 9f",
+  "\tneg %eax",
+  "9:\tret",
+  "",
+  "# --- ENDPROG",
+  "plc_exit:",
+  "\tcall plc_flush",
+  "\tmov $60, %eax",
+  "\txor %edi, %edi",
+  "\tsyscall",
+  "",
+  "# --- after a runtime error: write the message set up by the",
+  "# handler to stderr, then exit with EXIT_FAILURE",
+  "plc_fail:",
+  "\tmov %esi, %r14d",
+  "\tcall plc_flush",
+  "\tmov $2, %edi",
+  "\tlea plc_prefix(%rip), %rsi",
+  "\tmov $plc_prefix_length, %edx",
+  "\tcall plc_put",
+  "\tmov $2, %edi",
+  "\tmov %rbp, %rsi",
+  "\tmov %r12, %rdx",
+  "\tcall plc_put",
+  "\ttest %r13, %r13",
+  "\tjz 1f",
+  "\tmov %r14d, %eax",
+  "\tcall plc_itoa",
+  "\tmov $2, %edi",
+  "\tcall plc_put",
+  "\tmov $2, %edi",
+  "\tmov %r13, %rsi",
+  "\tmov %r15, %rdx",
+  "\tcall plc_put",
+  "1:\tmov $60, %eax",
+  "\tmov $1, %edi",
+  "\tsyscall",
+  ""
+};
+
+/*----------------------------------------------------------------------
+  Helper Functions
+----------------------------------------------------------------------*/
+
+/* --- a string as an assembler string literal */
+static string quote (string const & s) {
+  string r = "\"";
+  for (string::const_iterator it = s.begin (); it != s.end (); ++it) {
+    switch (*it) {
+    case '\n': r += "\\n";     break;
+    case '"':  r += "\\\"";    break;
+    case '\\': r += "\\\\";    break;
+    default:   r += *it;       break;
+    }
+  }
+  return r + "\"";
+}
+
+/*----------------------------------------------------------------------
+  Main Methods
+----------------------------------------------------------------------*/
+
+gas::gas (ostream & out, string const & source)
+  : _out (out), _source (source), _returns (0) {
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- set up the machine's registers; the program follows */
+void gas::prologue () {
+  _out << "# " << _source << ": translated by " << PACKAGE_STRING << endl
+       << endl
+       << "\t.text" << endl
+       << "\t.globl _start" << endl
+       << "_start:" << endl
+       << "\tlea plc_stack(%rip), %rbx" << endl
+       << "\tlea -4(%rbx), %r12" << endl
+       << "\tlea " << 4 * (STACK_SIZE - 1) << "(%rbx), %r15" << endl
+       << "\txor %r13d, %r13d" << endl;
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- the run-time support and the program's data */
+void gas::epilogue () {
+  unsigned int i;
+  _out << endl
+       << "\t.set plc_buffer_size, " << BUFFER_SIZE << endl << endl;
+  for (i = 0; i < count_of (runtime); ++i) {
+    _out << runtime[i] << endl;
+  }
+  for (i = 0; i < count_of (failures); ++i) {
+    message (i);
+  }
+  _out << "\t.section .rodata" << endl
+       << "plc_prefix:" << endl
+       << "\t.ascii " << quote (_source + ": runtime error: ") << endl
+       << "\t.set plc_prefix_length, . - plc_prefix" << endl;
+  for (i = 0; i < count_of (failures); ++i) {
+    string m  = rterr::message (failures[i].code);
+    string::size_type at = m.find ("%d");
+    _out << failures[i].name << "_head:" << endl
+	 << "\t.ascii " << quote (m.substr (0, at)) << endl;
+    if (string::npos != at) {
+      _out << failures[i].name << "_tail:" << endl
+	   << "\t.ascii " << quote (m.substr (at + 2)) << endl;
+    }
+    _out << failures[i].name << "_end:" << endl;
+  }
+  _out << endl
+       << "\t.lcomm plc_stack, " << 4 * STACK_SIZE << endl
+       << "\t.lcomm plc_output, " << BUFFER_SIZE << endl
+       << "\t.lcomm plc_output_length, 8" << endl
+       << "\t.lcomm plc_input_buffer, " << BUFFER_SIZE << endl
+       << "\t.lcomm plc_input_length, 8" << endl
+       << "\t.lcomm plc_input_next, 8" << endl
+       << "\t.lcomm plc_digits, 16" << endl
+       << "\t.section .note.GNU-stack,\"\",@progbits" << endl;
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- the handler for a runtime error: passes the pieces of the
+   message around the number, if any, on to plc_fail (the machine's
+   registers are no longer needed) */
+void gas::message (int i) {
+  string name = failures[i].name;
+  bool   arg  = string::npos
+    != string (rterr::message (failures[i].code)).find ("%d");
+  _out << name << ":" << endl
+       << "\tlea " << name << "_head(%rip), %rbp" << endl
+       << "\tmov $" << name << (arg ? "_tail" : "_end") << " - " << name
+       << "_head, %r12" << endl;
+  if (arg) {
+    _out << "\tlea " << name << "_tail(%rip), %r13" << endl
+	 << "\tmov $" << name << "_end - " << name << "_tail, %r15" << endl;
+  } else {
+    _out << "\txor %r13d, %r13d" << endl;
+  }
+  _out << "\tjmp plc_fail" << endl << endl;
+}
+
+/* --------------------------------------------------------------------*/
+
+void gas::emit (int op) {
+  instruction (op, 0, 0);
+}
+
+/* --------------------------------------------------------------------*/
+
+void gas::emit (int op, int x) {
+  instruction (op, x, 0);
+}
+
+/* --------------------------------------------------------------------*/
+
+void gas::emit (int op, int x, int y) {
+  instruction (op, x, y);
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- one instruction: x and y are its operands, which are symbolic
+   where the parser's are (addresses, and the variable lengths) */
+void gas::instruction (int op, int x, int y) {
+  int level, i;
+  if (op < opcode::last) {
+    _out << "# " << opcode::name (static_cast<opcode::code> (op)) << endl;
+  }
+  switch (op) {
+  case opcode::add:
+    _out << "\tmov (%r12), %eax" << endl
+	 << "\tsub $4, %r12" << endl
+	 << "\tadd %eax, (%r12)" << endl;
+    break;
+  case opcode::and$:
+  case opcode::or$:
+    _out << "\tmov (%r12), %eax" << endl
+	 << "\tsub $4, %r12" << endl
+	 << "\tcmpl $0, (%r12)" << endl
+	 << (opcode::and$ == op ? "\tje 1f" : "\tjne 1f") << endl
+	 << "\tmov %eax, (%r12)" << endl
+	 << "1:" << endl;
+    break;
+  case opcode::arrow:
+    _out << "\tmov (%r12), %eax" << endl
+	 << "\tsub $4, %r12" << endl
+	 << "\ttest %eax, %eax" << endl
+	 << "\tjz .L" << x << endl;
+    break;
+  case opcode::assign:
+    /* -- addresses at st[s-2n+1 .. s-n], values above them */
+    _out << "\tsub $" << 8 * x << ", %r12" << endl;
+    for (i = 1; i <= x; ++i) {
+      _out << "\tmovslq " << 4 * i << "(%r12), %rax" << endl
+	   << "\tmov " << 4 * (i + x) << "(%r12), %ecx" << endl
+	   << "\tmov %ecx, (%rbx,%rax,4)" << endl;
+    }
+    break;
+  case opcode::bar:
+    _out << "\tjmp .L" << x << endl;
+    break;
+  case opcode::call:
+    _out << "\tlea 12(%r12), %rax" << endl
+	 << "\tcmp %r15, %rax" << endl
+	 << "\tja plc_overflow" << endl
+	 << "\tmov %r13, %rax" << endl;
+    for (level = x; level > 0; --level) {
+      _out << "\tmovslq (%rbx,%rax,4), %rax" << endl;
+    }
+    _out << "\tmov %eax, 4(%r12)" << endl
+	 << "\tmov %r13d, 8(%r12)" << endl
+	 << "\tmovl $.Lr" << _returns << ", 12(%r12)" << endl
+	 << "\tlea 4(%r12), %r13" << endl
+	 << "\tsub %rbx, %r13" << endl
+	 << "\tshr $2, %r13" << endl
+	 << "\tadd $12, %r12" << endl
+	 << "\tjmp .L" << y << endl
+	 << ".Lr" << _returns << ":" << endl;
+    ++_returns;
+    break;
+  case opcode::constant:
+    _out << "\tcmp %r15, %r12" << endl
+	 << "\tjae plc_overflow" << endl
+	 << "\tadd $4, %r12" << endl
+	 << "\tmovl $" << x << ", (%r12)" << endl;
+    break;
+  case opcode::divide:
+  case opcode::modulo:
+    _out << "\tmov (%r12), %ecx" << endl
+	 << "\tsub $4, %r12" << endl
+	 << "\ttest %ecx, %ecx" << endl
+	 << "\tjz plc_divide_by_zero" << endl
+	 << "\tmov (%r12), %eax" << endl
+	 << "\tcltd" << endl
+	 << "\tidiv %ecx" << endl
+	 << (opcode::divide == op ? "\tmov %eax, (%r12)" : "\tmov %edx, (%r12)")
+	 << endl;
+    break;
+  case opcode::end_procedure:
+    _out << "\tlea -4(%rbx,%r13,4), %r12" << endl
+	 << "\tmov 8(%rbx,%r13,4), %eax" << endl
+	 << "\tmovslq 4(%rbx,%r13,4), %r13" << endl
+	 << "\tjmp *%rax" << endl;
+    break;
+  case opcode::end_program:
+    _out << "\tjmp plc_exit" << endl;
+    break;
+  case opcode::equal:
+  case opcode::greater:
+  case opcode::less:
+    _out << "\tmov (%r12), %eax" << endl
+	 << "\tsub $4, %r12" << endl
+	 << "\tcmp %eax, (%r12)" << endl
+	 << (opcode::equal == op ? "\tsete %al"
+	     : opcode::less == op ? "\tsetl %al" : "\tsetg %al") << endl
+	 << "\tmovzbl %al, %eax" << endl
+	 << "\tmov %eax, (%r12)" << endl;
+    break;
+  case opcode::fi:
+    _out << "\tmov $" << x << ", %esi" << endl
+	 << "\tjmp plc_if_fails" << endl;
+    break;
+  case opcode::index:
+    /* -- 1 <= x <= bound, as one unsigned comparison of x - 1 */
+    _out << "\tmov (%r12), %eax" << endl
+	 << "\tsub $4, %r12" << endl
+	 << "\tlea -1(%rax), %ecx" << endl
+	 << "\tcmp $" << (x > 0 ? x : 0) << ", %ecx" << endl
+	 << "\tjb 1f" << endl
+	 << "\tmov $" << y << ", %esi" << endl
+	 << "\tjmp plc_range" << endl
+	 << "1:\tadd %ecx, (%r12)" << endl;
+    break;
+  case opcode::minus:
+    _out << "\tnegl (%r12)" << endl;
+    break;
+  case opcode::multiply:
+    _out << "\tmov (%r12), %ecx" << endl
+	 << "\tsub $4, %r12" << endl
+	 << "\tmov (%r12), %eax" << endl
+	 << "\timul %ecx, %eax" << endl
+	 << "\tmov %eax, (%r12)" << endl;
+    break;
+  case opcode::not$:
+    _out << "\tcmpl $0, (%r12)" << endl
+	 << "\tsete %al" << endl
+	 << "\tmovzbl %al, %eax" << endl
+	 << "\tmov %eax, (%r12)" << endl;
+    break;
+  case opcode::procedure:
+    _out << "\tlea 4*.Lv" << x << "(%r12), %rax" << endl
+	 << "\tcmp %r15, %rax" << endl
+	 << "\tja plc_overflow" << endl
+	 << "\tmov %rax, %r12" << endl
+	 << "\tjmp .L" << y << endl;
+    break;
+  case opcode::program:
+    /* -- the outermost block has no links, but keeps the same layout
+       as a procedure's activation record */
+    _out << "\txor %r13d, %r13d" << endl
+	 << "\tmovl $0, (%rbx)" << endl
+	 << "\tmovl $0, 4(%rbx)" << endl
+	 << "\tmovl $0, 8(%rbx)" << endl
+	 << "\tlea 8+4*.Lv" << x << "(%rbx), %r12" << endl
+	 << "\tcmp %r15, %r12" << endl
+	 << "\tja plc_overflow" << endl
+	 << "\tjmp .L" << y << endl;
+    break;
+  case opcode::read:
+    _out << "\tsub $" << 4 * x << ", %r12" << endl;
+    for (i = 1; i <= x; ++i) {
+      _out << "\tcall plc_read" << endl
+	   << "\tmovslq " << 4 * i << "(%r12), %rcx" << endl
+	   << "\tmov %eax, (%rbx,%rcx,4)" << endl;
+    }
+    break;
+  case opcode::subtract:
+    _out << "\tmov (%r12), %eax" << endl
+	 << "\tsub $4, %r12" << endl
+	 << "\tsub %eax, (%r12)" << endl;
+    break;
+  case opcode::value:
+    _out << "\tmovslq (%r12), %rax" << endl
+	 << "\tmov (%rbx,%rax,4), %eax" << endl
+	 << "\tmov %eax, (%r12)" << endl;
+    break;
+  case opcode::variable:
+    _out << "\tcmp %r15, %r12" << endl
+	 << "\tjae plc_overflow" << endl
+	 << "\tmov %r13, %rax" << endl;
+    for (level = x; level > 0; --level) {
+      _out << "\tmovslq (%rbx,%rax,4), %rax" << endl;
+    }
+    _out << "\tadd $" << y << ", %rax" << endl
+	 << "\tadd $4, %r12" << endl
+	 << "\tmov %eax, (%r12)" << endl;
+    break;
+  case opcode::write:
+    _out << "\tsub $" << 4 * x << ", %r12" << endl;
+    for (i = 1; i <= x; ++i) {
+      _out << "\tmov " << 4 * i << "(%r12), %eax" << endl
+	   << "\tcall plc_write" << endl;
+    }
+    break;
+  case ir::define_address:
+    _out << ".L" << x << ":" << endl;
+    break;
+  case ir::define_argument:
+    _out << "\t.set .Lv" << x << ", " << y << endl;
+    break;
+  }
+}
@@ -0,0 +1,60 @@
+/*----------------------------------------------------------------------
+  File    : gas.h
+  Contents: PL machine to x86-64 GNU assembler emitter
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#ifndef GAS_H
+#define GAS_H
+
+#include "emitter.h"
+#include <iostream>
+#include <string>
+
+/*----------------------------------------------------------------------
+  Main Class - an emitter that writes each instruction the parser
+  generates as x86-64 assembly (AT&T syntax), rather than as machine
+  code.  The result is a complete program for Linux, which does its
+  own I/O with system calls, so it needs nothing but binutils:
+
+    as -o prog.o prog.s && ld -o prog prog.o
+
+  The instruction templates are those of the JIT (see jit.cc), and
+  the generated code keeps the same registers and stack layout.  The
+  parser's labels and DEFARG values become assembler symbols, so the
+  assembler resolves the forward references for us.
+----------------------------------------------------------------------*/
+
+class gas : public emitter_interface {
+
+private:
+
+  std::ostream &_out;           /* assembly output */
+  std::string   _source;        /* name of the PL source file */
+  int           _returns;       /* return labels generated so far */
+
+  void instruction (int, int, int);
+  void message (int);
+
+public:
+
+  gas (std::ostream&, std::string const&);
+
+  void prologue ();
+  void epilogue ();
+
+  void emit (int);
+  void emit (int, int);
+  void emit (int, int , int);
+
+};
+
+#endif
+
+/*----------------------------------------------------------------------
+  Emacs Configuration
+  Local Variables:
+  mode: C++
+  End:
+----------------------------------------------------------------------*/
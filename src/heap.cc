@@ -0,0 +1,114 @@
+/*----------------------------------------------------------------------
+  File    : heap.cc
+  Contents: Counts the program's heap allocations
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef HEAP_COUNT
+
+#include "heap.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+/*----------------------------------------------------------------------
+  Global Variables
+----------------------------------------------------------------------*/
+
+static std::atomic<unsigned long> count (0);
+
+/*----------------------------------------------------------------------
+  Main Functions
+----------------------------------------------------------------------*/
+
+unsigned long heap::allocations () {
+  return count.load (std::memory_order_relaxed);
+}
+
+/*----------------------------------------------------------------------
+  Replacement Operators - every form is replaced, not only the one
+  that counts, since a library may supply the others itself (the 
+  sanitizers do), and what they allocate would then come back to a 
+  delete that does not match
+----------------------------------------------------------------------*/
+
+void* operator new (size_t n) {
+  count.fetch_add (1, std::memory_order_relaxed);
+  void *p = malloc (n ? n : 1);
+  if (!p) {
+    throw std::bad_alloc ();
+  }
+  return p;
+}
+
+/* --------------------------------------------------------------------*/
+
+void* operator new[] (size_t n) {
+  return operator new (n);
+}
+
+/* --------------------------------------------------------------------*/
+
+void* operator new (size_t n, std::nothrow_t const &) noexcept {
+  try {
+    return operator new (n);
+  } catch (std::bad_alloc const &) {
+    return NULL;
+  }
+}
+
+/* --------------------------------------------------------------------*/
+
+void* operator new[] (size_t n, std::nothrow_t const &) noexcept {
+  return operator new (n, std::nothrow);
+}
+
+/* --------------------------------------------------------------------*/
+
+void operator delete (void *p) noexcept {
+  free (p);
+}
+
+/* --------------------------------------------------------------------*/
+
+void operator delete[] (void *p) noexcept {
+  free (p);
+}
+
+/* --------------------------------------------------------------------*/
+
+void operator delete (void *p, size_t) noexcept {
+  free (p);
+}
+
+/* --------------------------------------------------------------------*/
+
+void operator delete[] (void *p, size_t) noexcept {
+  free (p);
+}
+
+/* --------------------------------------------------------------------*/
+
+void operator delete (void *p, std::nothrow_t const &) noexcept {
+  free (p);
+}
+
+/* --------------------------------------------------------------------*/
+
+void operator delete[] (void *p, std::nothrow_t const &) noexcept {
+  free (p);
+}
+
+#endif
+
+/*----------------------------------------------------------------------
+  Emacs Configuration
+  Local Variables:
+  mode: C++
+  End:
+----------------------------------------------------------------------*/
@@ -0,0 +1,32 @@
+/*----------------------------------------------------------------------
+  File    : heap.h
+  Contents: Counts the program's heap allocations
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#ifndef HEAP_H
+#define HEAP_H
+
+/*----------------------------------------------------------------------
+  Heap - in a build configured with --enable-heap-count, the global
+  operator new is replaced by one that counts its calls (on every
+  thread) before going to malloc, so that -v can say how many
+  allocations a phase of the compiler made.  Otherwise, nothing is
+  replaced, and none of this is compiled in.
+----------------------------------------------------------------------*/
+
+namespace heap {
+
+  unsigned long allocations ();  /* made so far */
+
+}
+
+#endif
+
+/*----------------------------------------------------------------------
+  Emacs Configuration
+  Local Variables:
+  mode: C++
+  End:
+----------------------------------------------------------------------*/
@@ -0,0 +1,217 @@
+/*----------------------------------------------------------------------
+  File    : image.cc
+  Contents: Binary program images
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "image.h"
+#include "opcode.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*----------------------------------------------------------------------
+  Namespace Inclusions
+----------------------------------------------------------------------*/
+
+using std::ifstream;
+using std::ostream;
+using std::vector;
+
+/*----------------------------------------------------------------------
+  Constants
+----------------------------------------------------------------------*/
+
+static const char     magic[4]    = { 'P', 'L', 'M', 'I' };
+static const unsigned version     = 1;
+static const unsigned header_size = 32; /* bytes: 8 words */
+
+/*----------------------------------------------------------------------
+  Helper Functions
+----------------------------------------------------------------------*/
+
+static void put32 (ostream & out, unsigned int x) {
+  char b[4] = { static_cast<char> (x), static_cast<char> (x >> 8),
+		static_cast<char> (x >> 16), static_cast<char> (x >> 24) };
+  out.write (b, sizeof (b));
+}
+
+/* --------------------------------------------------------------------*/
+
+static unsigned int get32 (unsigned char const *b) {
+  return b[0] | (b[1] << 8) | (b[2] << 16)
+    | (static_cast<unsigned int> (b[3]) << 24);
+}
+
+/* --------------------------------------------------------------------*/
+
+static bool little_endian () {
+  unsigned int one = 1;
+  return 1 == *reinterpret_cast<unsigned char*> (&one);
+}
+
+/*----------------------------------------------------------------------
+  Program Methods
+----------------------------------------------------------------------*/
+
+image::program::program ()
+  : _map (NULL), _size (0), _code (NULL), _blocks (NULL), _lines (NULL),
+    _words (0), _block_count (0), _line_count (0) {
+}
+
+/* --------------------------------------------------------------------*/
+
+image::program::~program () {
+  if (_map) {
+    munmap (_map, _size);
+  }
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- map the image in; false if it cannot be read, or is not an
+   image we understand.  An image comes from outside, so its code is
+   checked as well (see opcode::check): every engine can then run it 
+   without checking as it goes */
+bool image::program::load (char const *fn) {
+  struct stat st;
+  int fd = open (fn, O_RDONLY);
+  if (-1 == fd) {
+    return false;
+  }
+  if (0 != fstat (fd, &st) || st.st_size < static_cast<off_t> (header_size)) {
+    close (fd);
+    return false;
+  }
+  void *p = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (MAP_FAILED == p) {
+    return false;
+  }
+  _map  = p;
+  _size = st.st_size;
+
+  /* --- check the header, and that the tables fit in the file --- */
+  unsigned char const *b = static_cast<unsigned char const*> (p);
+  if (0 != memcmp (b, magic, sizeof (magic)) || version != get32 (b + 4)
+      || header_size != get32 (b + 8)) {
+    return false;
+  }
+  _words       = get32 (b + 12);
+  _block_count = get32 (b + 16);
+  _line_count  = get32 (b + 20);
+  size_t total = _words + 3 * _block_count + 2 * _line_count;
+  if (_words > _size || _block_count > _size || _line_count > _size
+      || header_size + 4 * total > _size) {
+    return false;
+  }
+
+  /* --- on a little-endian host the words are used where they lie;
+     anywhere else, they are converted in to a copy --- */
+  int const *words = reinterpret_cast<int const*> (b + header_size);
+  if (!little_endian ()) {
+    _copy.resize (total);
+    for (size_t i = 0; i < total; ++i) {
+      _copy[i] = static_cast<int> (get32 (b + header_size + 4 * i));
+    }
+    words = _copy.empty () ? NULL : &_copy[0];
+  }
+  _code   = words;
+  _blocks = words + _words;
+  _lines  = _blocks + 3 * _block_count;
+  return -1 == opcode::check (_code, _words);
+}
+
+/* --------------------------------------------------------------------*/
+
+image::block image::program::block_at (size_t i) const {
+  block b = { _blocks[3 * i], _blocks[3 * i + 1], _blocks[3 * i + 2] };
+  return b;
+}
+
+/* --------------------------------------------------------------------*/
+
+image::line image::program::line_at (size_t i) const {
+  line l = { _lines[2 * i], _lines[2 * i + 1] };
+  return l;
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- the source line of the code at an address (0 if unknown) */
+int image::program::line_of (int address) const {
+  size_t lo = 0, hi = _line_count;  /* first entry past the address */
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if (_lines[2 * mid] <= address) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo ? _lines[2 * (lo - 1) + 1] : 0;
+}
+
+/*----------------------------------------------------------------------
+  Functions
+----------------------------------------------------------------------*/
+
+bool image::is_image (char const *fn) {
+  char     b[sizeof (magic)];
+  ifstream in (fn, ifstream::in | ifstream::binary);
+  return in.read (b, sizeof (b)) && 0 == memcmp (b, magic, sizeof (magic));
+}
+
+/* --------------------------------------------------------------------*/
+
+bool image::write (ostream & out, vector<int> const & code,
+		   vector<line> const & lines) {
+  vector<block> blocks;
+  int n = code.size (), length;
+  for (int p = 0; p < n; p += length) {
+    length = opcode::length (code[p]);
+    if (!length || p + length > n) {
+      break;                    /* (not code we can make sense of) */
+    }
+    if (opcode::program == code[p] || opcode::procedure == code[p]) {
+      block b = { p, code[p + 1], code[p + 2] };
+      blocks.push_back (b);
+    }
+  }
+
+  out.write (magic, sizeof (magic));
+  put32 (out, version);
+  put32 (out, header_size);
+  put32 (out, code.size ());
+  put32 (out, blocks.size ());
+  put32 (out, lines.size ());
+  put32 (out, 0);               /* (reserved) */
+  put32 (out, 0);
+  if (little_endian () && !code.empty ()) {
+    out.write (reinterpret_cast<char const*> (&code[0]), 4 * code.size ());
+  } else {
+    for (size_t i = 0; i < code.size (); ++i) {
+      put32 (out, code[i]);
+    }
+  }
+  for (size_t i = 0; i < blocks.size (); ++i) {
+    put32 (out, blocks[i].address);
+    put32 (out, blocks[i].length);
+    put32 (out, blocks[i].begin);
+  }
+  for (size_t i = 0; i < lines.size (); ++i) {
+    put32 (out, lines[i].address);
+    put32 (out, lines[i].number);
+  }
+  return out.good ();
+}
@@ -0,0 +1,99 @@
+/*----------------------------------------------------------------------
+  File    : image.h
+  Contents: Binary program images
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#ifndef IMAGE_H
+#define IMAGE_H
+
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+/*----------------------------------------------------------------------
+  Image Format - an assembled program, laid out so that it can be
+  mapped in to memory and run as it is.  Every field is a 32 bit
+  little-endian word:
+
+    header       magic ("PLMI"), version, header size in bytes, and
+                 the number of code words, blocks and line entries
+    code         the machine code, exactly as the text format has it
+    blocks       per block (the program first, then each procedure):
+                 the address of its PROG or PROC, the length of its
+                 variables, and the address of its first statement
+    lines        (address, source line) pairs, in address order; each
+                 line covers the code up to the next entry's address
+
+  The text format (one decimal word per line) remains the default;
+  plimage converts between the two.
+----------------------------------------------------------------------*/
+
+namespace image {
+
+  /* --- a block, as listed in the block table */
+  struct block {
+    int address;                /* address of the PROG or PROC */
+    int length;                 /* words of variables */
+    int begin;                  /* address of the first statement */
+  };
+
+  /* --- an entry in the line table */
+  struct line {
+    int address;                /* first word of the line's code */
+    int number;                 /* source line */
+  };
+
+  /* --- a loaded image; the words point in to the mapped file when the
+     host is little-endian, or in to a converted copy otherwise */
+  class program {
+
+  private:
+
+    void             *_map;     /* file mapping (or NULL) */
+    size_t            _size;    /* size of the mapping */
+    std::vector<int>  _copy;    /* the words, if they had to be copied */
+    int const        *_code;    /* code words */
+    int const        *_blocks;  /* block table, 3 words per entry */
+    int const        *_lines;   /* line table, 2 words per entry */
+    size_t            _words, _block_count, _line_count;
+
+    program (program const&);
+    program& operator= (program const&);
+
+  public:
+
+    program ();
+    ~program ();
+
+    bool load (char const*);
+
+    int const* code () const       { return _code; }
+    size_t     words () const      { return _words; }
+    size_t     blocks () const     { return _block_count; }
+    size_t     lines () const      { return _line_count; }
+    block      block_at (size_t) const;
+    line       line_at (size_t) const;
+    int        line_of (int) const;
+
+  };
+
+  /* --- true if the file starts with an image header */
+  bool is_image (char const*);
+
+  /* --- write a program as an image; the block table is found from
+     the code itself */
+  bool write (std::ostream&, std::vector<int> const&,
+	      std::vector<line> const&);
+
+}
+
+#endif
+
+/*----------------------------------------------------------------------
+  Emacs Configuration
+  Local Variables:
+  mode: C++
+  End:
+----------------------------------------------------------------------*/
@@ -0,0 +1,144 @@
+/*----------------------------------------------------------------------
+  File    : instructions.h
+  Contents: PL machine instruction handlers
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+/* --- NOTE: there are no include guards on purpose.  This file is
+   included in the body of each of the interpreter's dispatch loops,
+   which define:
+
+     INSTRUCTION(x)  the start of the handler for opcode::x
+     NEXT            continue with the instruction at p
+
+   and the registers code, st, top, p, b, s and the scratch words x and
+   level.  The handlers may also jump to the overflow and
+   divide_by_zero labels, or return the program's exit status. */
+
+INSTRUCTION (add)
+  --s; st[s] += st[s + 1]; p += 1;
+  NEXT;
+INSTRUCTION (and$)
+  --s; if (st[s]) { st[s] = st[s + 1]; } p += 1;
+  NEXT;
+INSTRUCTION (arrow)
+  p = st[s--] ? p + 2 : code[p + 1];
+  NEXT;
+INSTRUCTION (assign)
+  /* -- the stack holds count addresses followed by count values */
+  x = code[p + 1]; s -= 2 * x;
+  for (int i = 1; i <= x; ++i) {
+    st[st[s + i]] = st[s + i + x];
+  }
+  p += 2;
+  NEXT;
+INSTRUCTION (bar)
+  p = code[p + 1];
+  NEXT;
+INSTRUCTION (call)
+  /* -- follow the static links to the block the procedure was
+     defined in, then push the new activation record's links */
+  if (s + 3 > top) { goto overflow; }
+  for (x = b, level = code[p + 1]; level > 0; --level) {
+    x = st[x]; }
+  st[s + 1] = x; st[s + 2] = b; st[s + 3] = p + 3;
+  b = s + 1; s += 3; p = code[p + 2];
+  NEXT;
+INSTRUCTION (constant)
+  if (s >= top) { goto overflow; }
+  st[++s] = code[p + 1]; p += 2;
+  NEXT;
+INSTRUCTION (divide)
+  --s; if (!st[s + 1]) { goto divide_by_zero; }
+  st[s] /= st[s + 1]; p += 1;
+  NEXT;
+INSTRUCTION (end_procedure)
+  s = b - 1; p = st[b + 2]; b = st[b + 1];
+  NEXT;
+INSTRUCTION (end_program)
+  return EXIT_SUCCESS;
+INSTRUCTION (equal)
+  --s; st[s] = (st[s] == st[s + 1]); p += 1;
+  NEXT;
+INSTRUCTION (fi)
+  _errors.error (rterr::if_fails, code[p + 1]);
+  return EXIT_FAILURE;
+INSTRUCTION (greater)
+  --s; st[s] = (st[s] > st[s + 1]); p += 1;
+  NEXT;
+INSTRUCTION (index)
+  /* -- arrays are indexed from 1 to their bound */
+  x = st[s--];
+  if (x < 1 || x > code[p + 1]) {
+    _errors.error (rterr::range, code[p + 2]);
+    return EXIT_FAILURE;
+  }
+  st[s] += x - 1; p += 3;
+  NEXT;
+INSTRUCTION (less)
+  --s; st[s] = (st[s] < st[s + 1]); p += 1;
+  NEXT;
+INSTRUCTION (minus)
+  st[s] = -st[s]; p += 1;
+  NEXT;
+INSTRUCTION (modulo)
+  --s; if (!st[s + 1]) { goto divide_by_zero; }
+  st[s] %= st[s + 1]; p += 1;
+  NEXT;
+INSTRUCTION (multiply)
+  --s; st[s] *= st[s + 1]; p += 1;
+  NEXT;
+INSTRUCTION (not$)
+  st[s] = !st[s]; p += 1;
+  NEXT;
+INSTRUCTION (or$)
+  --s; if (!st[s]) { st[s] = st[s + 1]; } p += 1;
+  NEXT;
+INSTRUCTION (procedure)
+  if (s + code[p + 1] > top) { goto overflow; }
+  s += code[p + 1]; p = code[p + 2];
+  NEXT;
+INSTRUCTION (program)
+  /* -- the outermost block has no links, but keeps the same layout
+     as a procedure's activation record */
+  if (2 + code[p + 1] > top) { goto overflow; }
+  b = 0; st[0] = st[1] = st[2] = 0;
+  s = 2 + code[p + 1]; p = code[p + 2];
+  NEXT;
+INSTRUCTION (read)
+  x = code[p + 1]; s -= x;
+  for (int i = 1; i <= x; ++i) {
+    if (!(_in >> st[st[s + i]])) {
+      _errors.error (rterr::input);
+      return EXIT_FAILURE;
+    }
+  }
+  p += 2;
+  NEXT;
+INSTRUCTION (subtract)
+  --s; st[s] -= st[s + 1]; p += 1;
+  NEXT;
+INSTRUCTION (value)
+  st[s] = st[st[s]]; p += 1;
+  NEXT;
+INSTRUCTION (variable)
+  if (s >= top) { goto overflow; }
+  for (x = b, level = code[p + 1]; level > 0; --level) {
+    x = st[x]; }
+  st[++s] = x + code[p + 2]; p += 3;
+  NEXT;
+INSTRUCTION (write)
+  x = code[p + 1]; s -= x;
+  for (int i = 1; i <= x; ++i) {
+    _out << st[s + i] << '\n';
+  }
+  p += 2;
+  NEXT;
+
+/*----------------------------------------------------------------------
+  Emacs Configuration
+  Local Variables:
+  mode: C++
+  End:
+----------------------------------------------------------------------*/
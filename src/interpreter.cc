@@ -0,0 +1,151 @@
+/*----------------------------------------------------------------------
+  File    : interpreter.cc
+  Contents: PL machine interpreter
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "interpreter.h"
+#include "opcode.h"
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+/*----------------------------------------------------------------------
+  Namespace Inclusions
+----------------------------------------------------------------------*/
+
+using std::istream;
+using std::ostream;
+using std::vector;
+
+namespace rterr = error::runtime;
+
+/*----------------------------------------------------------------------
+  Main Methods
+----------------------------------------------------------------------*/
+
+interpreter::interpreter (int const *code, size_t size, error_interface & err,
+			  istream & in, ostream & out, dispatch::code d)
+  : _code (code), _size (size), _stack (STACK_SIZE), _errors (err), _in (in),
+    _out (out), _dispatch (supported (d) ? d : dispatch::switched) {
+}
+
+/* --------------------------------------------------------------------*/
+
+bool interpreter::supported (dispatch::code d) {
+#ifdef HAVE_COMPUTED_GOTO
+  return true;
+#else
+  return dispatch::switched == d;
+#endif
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- neither loop checks the program as it goes, so it is checked 
+   first, as the JIT does: an instruction or jump that would leave the
+   program stops it before it starts */
+int interpreter::run () {
+  int p = opcode::check (_code, _size);
+  if (-1 != p) {
+    _errors.error (rterr::instruction, 
+		   p < static_cast<int> (_size) ? _code[p] : 0, p);
+    return EXIT_FAILURE;
+  }
+  if (dispatch::threaded == _dispatch) {
+    return run_threaded ();
+  }
+  return run_switched ();
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- the portable loop: decode each operation code with a switch */
+int interpreter::run_switched () {
+  int const *code = _code;      /* program */
+  int       *st   = &_stack[0]; /* stack */
+  int        top  = STACK_SIZE - 1; /* highest usable stack address */
+  int        p    = 0,          /* program register */
+             b    = 0,          /* base (activation record) register */
+             s    = -1;         /* stack register: top word */
+  int        x, level;
+
+#define INSTRUCTION(x) case opcode::x:
+#define NEXT           break
+  for (;;) {
+    switch (code[p]) {
+#include "instructions.h"
+    default:
+      _errors.error (rterr::instruction, code[p], p);
+      return EXIT_FAILURE;
+    }
+  }
+#undef INSTRUCTION
+#undef NEXT
+
+ overflow:
+  _errors.error (rterr::stack_overflow);
+  return EXIT_FAILURE;
+
+ divide_by_zero:
+  _errors.error (rterr::divide_by_zero);
+  return EXIT_FAILURE;
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- the direct-threaded loop: before we start, every operation code
+   is replaced by the address of its handler (in a table parallel to
+   the program, so the operands and jump targets stay as they are), 
+   and each handler then jumps straight to the next one */
+int interpreter::run_threaded () {
+#ifdef HAVE_COMPUTED_GOTO
+  int const *code = _code;      /* program */
+  int       *st   = &_stack[0]; /* stack */
+  int        top  = STACK_SIZE - 1; /* highest usable stack address */
+  int        p    = 0,          /* program register */
+             b    = 0,          /* base (activation record) register */
+             s    = -1;         /* stack register: top word */
+  int        x, level;
+
+  /* --- handler addresses, in operation code order */
+  static void * const handlers[] = {
+    &&add, &&and$, &&arrow, &&assign, &&bar, &&call, &&constant, 
+    &&divide, &&end_procedure, &&end_program, &&equal, &&fi, &&greater,
+    &&index, &&less, &&minus, &&modulo, &&multiply, &&not$, &&or$, 
+    &&procedure, &&program, &&read, &&subtract, &&value, &&variable, 
+    &&write
+  };
+  
+  /* --- translate the program (which run () has checked) */
+  vector<void*> handler (_size);
+  void **thread = &handler[0];
+  for (p = 0; p < static_cast<int> (_size); 
+       p += opcode::length (code[p])) {
+    thread[p] = handlers[code[p]];
+  }
+  p = 0;
+
+#define INSTRUCTION(x) x:
+#define NEXT           goto *thread[p]
+  NEXT;
+#include "instructions.h"
+#undef INSTRUCTION
+#undef NEXT
+
+ overflow:
+  _errors.error (rterr::stack_overflow);
+  return EXIT_FAILURE;
+
+ divide_by_zero:
+  _errors.error (rterr::divide_by_zero);
+  return EXIT_FAILURE;
+#else
+  return run_switched ();
+#endif
+}
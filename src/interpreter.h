@@ -0,0 +1,81 @@
+/*----------------------------------------------------------------------
+  File    : interpreter.h
+  Contents: PL machine interpreter
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#ifndef INTERPRETER_H
+#define INTERPRETER_H
+
+#include "error.h"
+#include <iostream>
+#include <vector>
+
+/*----------------------------------------------------------------------
+  Preprocessor Definitions
+----------------------------------------------------------------------*/
+
+/* --- number of words in the machine's stack */
+#define STACK_SIZE  (1 << 20)
+
+/* --- direct threading relies on GCC's labels-as-values extension */
+#if defined (__GNUC__)
+#define HAVE_COMPUTED_GOTO 1
+#endif
+
+/*----------------------------------------------------------------------
+  Dispatch Codes - how the interpreter gets from one instruction to 
+  the next: a portable switch over the operation codes, or a jump 
+  straight to the handler's address, which the program is translated
+  in to when it is loaded (direct threading)
+----------------------------------------------------------------------*/
+
+namespace dispatch {
+  enum code {
+    switched,
+    threaded
+  };
+}
+
+/*----------------------------------------------------------------------
+  Main Class - executes the word stream written by the assembler.
+  The stack holds the activation records; each one starts with the
+  static link, the dynamic link and the return address, followed by
+  the block's variables (hence the first displacement of 3).
+----------------------------------------------------------------------*/
+
+class interpreter {
+
+private:
+
+  int const              *_code;  /* assembled program */
+  size_t                  _size;  /* words in the program */
+  std::vector<int>        _stack; /* machine stack */
+  error_interface        &_errors; /* error manager */
+  std::istream           &_in;    /* input for READ */
+  std::ostream           &_out;   /* output for WRITE */
+  dispatch::code          _dispatch; /* instruction dispatch method */
+
+  int run_switched ();
+  int run_threaded ();
+
+public:
+
+  interpreter (int const*, size_t, error_interface&,
+	       std::istream&, std::ostream&, 
+	       dispatch::code = dispatch::threaded);
+  int run ();
+
+  static bool supported (dispatch::code);
+
+};
+
+#endif
+
+/*----------------------------------------------------------------------
+  Emacs Configuration
+  Local Variables:
+  mode: C++
+  End:
+----------------------------------------------------------------------*/
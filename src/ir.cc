@@ -0,0 +1,110 @@
+/*----------------------------------------------------------------------
+  File    : ir.cc
+  Contents: Intermediate representation passed from parser to assembler
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "ir.h"
+#include "misc.h"
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/*----------------------------------------------------------------------
+  Preprocessor Definitions
+----------------------------------------------------------------------*/
+
+/* --- size of the mnemonic hash table (a power of two) */
+#define TABLE_SIZE 64
+
+/*----------------------------------------------------------------------
+  Constants
+----------------------------------------------------------------------*/
+
+/* --- the pseudo-instructions' mnemonics, in ir::pseudo order */
+static const char *pseudo_names[] = {
+  "DEFADDR",
+  "DEFARG"
+};
+
+/*----------------------------------------------------------------------
+  Helper Functions
+----------------------------------------------------------------------*/
+
+/* --- a hash that happens to be perfect for our 29 mnemonics, so a
+   lookup is one probe and one comparison */
+static unsigned int hash (char const *s, size_t n) {
+  return (2 * n + 5 * s[0] + 7 * s[n - 1] + s[1]) & (TABLE_SIZE - 1);
+}
+
+
+/* --------------------------------------------------------------------*/
+
+/* --- the table of operations by hash, built on first use.  Renaming
+   an operation can break the hash, so that is checked in every build,
+   not only with assertions on */
+static int const * table () {
+  static int slots[TABLE_SIZE];
+  static bool built = false;
+  if (!built) {
+    int last = opcode::last + count_of (pseudo_names);
+    for (int i = 0; i < TABLE_SIZE; ++i) {
+      slots[i] = -1;
+    }
+    for (int op = 0; op < last; ++op) {
+      char const *s = ir::name (op);
+      unsigned int h = hash (s, strlen (s));
+      if (-1 != slots[h]) {     /* (if so, find a new hash) */
+	fprintf (stderr, "internal error: mnemonics %s and %s share slot %u"
+		 " of the hash table\n", ir::name (slots[h]), s, h);
+	abort ();
+      }
+      slots[h] = op;
+    }
+    built = true;
+  }
+  return slots;
+}
+
+/*----------------------------------------------------------------------
+  Functions
+----------------------------------------------------------------------*/
+
+const char* ir::name (int op) {
+  assert (op >= 0 && op < define_argument + 1);
+  if (op < opcode::last) {
+    return opcode::name (static_cast<opcode::code> (op));
+  }
+  return pseudo_names[op - opcode::last];
+}
+
+/* --------------------------------------------------------------------*/
+
+int ir::operation (char const *s, size_t n) {
+  if (n < 2) {
+    return -1;
+  }
+  int op = table ()[hash (s, n)];
+  if (-1 == op) {
+    return -1;
+  }
+  char const *m = name (op);
+  return strlen (m) == n && 0 == memcmp (m, s, n) ? op : -1;
+}
+
+/* --------------------------------------------------------------------*/
+
+int ir::operands (int op) {
+  switch (op) {
+  case define_address:  return 1;
+  case define_argument: return 2;
+  }
+  int length = opcode::length (op);
+  return length ? length - 1 : -1;
+}
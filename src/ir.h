@@ -0,0 +1,59 @@
+/*----------------------------------------------------------------------
+  File    : ir.h
+  Contents: Intermediate representation passed from parser to assembler
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#ifndef IR_H
+#define IR_H
+
+#include "opcode.h"
+#include <cstddef>
+#include <vector>
+
+/*----------------------------------------------------------------------
+  Intermediate Code - the parser's output, as it is handed to the
+  assembler: one fixed size record per instruction, appended to a
+  contiguous buffer.  The operation is an opcode::code, or one of the
+  two pseudo-instructions below; the operands are those the parser
+  gave, so addresses and block lengths are still label numbers.
+----------------------------------------------------------------------*/
+
+namespace ir {
+
+  /* --- pseudo-instructions, which only the assembler sees */
+  enum pseudo {
+    define_address = opcode::last, /* DEFADDR label */
+    define_argument             /* DEFARG label value */
+  };
+
+  struct instruction {
+    int op;                     /* operation (opcode::code or pseudo) */
+    int x;                      /* first operand (or 0) */
+    int y;                      /* second operand (or 0) */
+  };
+
+  typedef std::vector<instruction> code;
+
+  /* --- the mnemonic of an operation code or pseudo-instruction */
+  const char* name (int);
+
+  /* --- the operation with the given mnemonic, be it an operation
+     code or a pseudo-instruction (or -1 if there is none) */
+  int operation (char const*, size_t);
+
+  /* --- number of operands the operation takes in assembly source
+     (or -1 if it is not an operation) */
+  int operands (int);
+
+}
+
+#endif
+
+/*----------------------------------------------------------------------
+  Emacs Configuration
+  Local Variables:
+  mode: C++
+  End:
+----------------------------------------------------------------------*/
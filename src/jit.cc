@@ -0,0 +1,497 @@
+/*----------------------------------------------------------------------
+  File    : jit.cc
+  Contents: PL machine to x86-64 translator (template JIT)
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "jit.h"
+#include "interpreter.h"
+#include "opcode.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#ifdef HAVE_JIT
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/*----------------------------------------------------------------------
+  Namespace Inclusions
+----------------------------------------------------------------------*/
+
+using std::istream;
+using std::make_pair;
+using std::ostream;
+using std::vector;
+
+namespace rterr = error::runtime;
+
+/*----------------------------------------------------------------------
+  Preprocessor Definitions
+----------------------------------------------------------------------*/
+
+/* --- append some raw machine code to the text, i.e.:
+
+   CODE (0x48, 0x89, 0xEF);     mov rdi, rbp
+*/
+#define CODE(...)							\
+  do {									\
+    static const unsigned char __code[] = { __VA_ARGS__ };		\
+    put (__code, sizeof (__code));					\
+  } while (0)
+
+/* --- marks a word that does not start an instruction */
+#define NO_OFFSET static_cast<size_t> (-1)
+
+/*----------------------------------------------------------------------
+  Register Usage - the machine's registers live in callee-saved
+  registers, so they survive the calls to the I/O helpers:
+
+    rbx   address of the stack (st[0])
+    r12   address of the top word (&st[s]); note s is a pointer here
+    r13   base register b (a word index, as the links on the stack are)
+    r14   native address of each program word, for ENDPROC's return
+    r15   address of the highest usable stack word
+    rbp   the jit object, passed on to the helpers
+
+  eax, ecx, edx, esi and edi are scratch.  Each instruction is
+  translated in to a fixed template; jumps to program words are
+  patched once every instruction has been translated.
+----------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------
+  Main Methods
+----------------------------------------------------------------------*/
+
+jit::jit (int const *code, size_t words, error_interface & err,
+	  istream & in, ostream & out)
+  : _code (code), _words (words), _stack (STACK_SIZE), _errors (err), _in (in),
+    _out (out), _memory (NULL), _size (0) {
+}
+
+/* --------------------------------------------------------------------*/
+
+jit::~jit () {
+#ifdef HAVE_JIT
+  if (_memory) {
+    munmap (_memory, _size);
+  }
+#endif
+}
+
+/* --------------------------------------------------------------------*/
+
+bool jit::supported () {
+#ifdef HAVE_JIT
+  return true;
+#else
+  return false;
+#endif
+}
+
+/* --------------------------------------------------------------------*/
+
+void jit::put (unsigned char const *p, size_t n) {
+  _text.insert (_text.end (), p, p + n);
+}
+
+/* --------------------------------------------------------------------*/
+
+void jit::imm32 (int x) {
+  unsigned char b[4];
+  memcpy (b, &x, sizeof (b));   /* (x86 is little-endian) */
+  put (b, sizeof (b));
+}
+
+/* --------------------------------------------------------------------*/
+
+void jit::imm64 (void const *x) {
+  unsigned char b[8];
+  memcpy (b, &x, sizeof (b));
+  put (b, sizeof (b));
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- relative displacement to code already generated */
+void jit::rel32 (size_t target) {
+  imm32 (static_cast<int> (target - (_text.size () + 4)));
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- relative displacement to a program word, filled in later */
+void jit::link (int word) {
+  _fixups.push_back (make_pair (_text.size (), word));
+  imm32 (0);
+}
+
+/* --------------------------------------------------------------------*/
+
+void jit::call (void const *f) {
+  CODE (0x48, 0xB8); imm64 (f); /* mov rax, f */
+  CODE (0xFF, 0xD0);            /* call rax */
+}
+
+/* --------------------------------------------------------------------*/
+
+bool jit::translate () {
+#ifdef HAVE_JIT
+  int const *code = _code;
+  int        n    = _words;
+  int        p, length, level, count;
+  size_t     epilogue, failure, overflow, divide_by_zero;
+
+  _offsets.assign (n, NO_OFFSET);
+
+  /* --- prologue: int entry (jit*, int *st, void **addresses,
+     int *top); keeps the stack 16 byte aligned for the helpers */
+  CODE (0x53, 0x55, 0x41, 0x54,  /* push rbx; push rbp; push r12 */
+	0x41, 0x55, 0x41, 0x56,  /* push r13; push r14 */
+	0x41, 0x57,              /* push r15 */
+	0x48, 0x83, 0xEC, 0x08,  /* sub rsp, 8 */
+	0x48, 0x89, 0xFD,        /* mov rbp, rdi */
+	0x48, 0x89, 0xF3,        /* mov rbx, rsi */
+	0x49, 0x89, 0xD6,        /* mov r14, rdx */
+	0x49, 0x89, 0xCF,        /* mov r15, rcx */
+	0x4C, 0x8D, 0x63, 0xFC,  /* lea r12, [rbx-4] (s = -1) */
+	0x45, 0x31, 0xED);       /* xor r13d, r13d (b = 0) */
+  CODE (0xE9); link (0);        /* jmp program */
+
+  /* --- epilogue: eax holds the exit status */
+  epilogue = _text.size ();
+  CODE (0x48, 0x83, 0xC4, 0x08,  /* add rsp, 8 */
+	0x41, 0x5F, 0x41, 0x5E,  /* pop r15; pop r14 */
+	0x41, 0x5D, 0x41, 0x5C,  /* pop r13; pop r12 */
+	0x5D, 0x5B, 0xC3);       /* pop rbp; pop rbx; ret */
+
+  /* --- run-time errors: edi holds the code, esi its argument */
+  failure = _text.size ();
+  CODE (0x89, 0xF2,             /* mov edx, esi */
+	0x89, 0xFE,             /* mov esi, edi */
+	0x48, 0x89, 0xEF);      /* mov rdi, rbp */
+  call (reinterpret_cast<void const*> (&jit::fail));
+  CODE (0xB8); imm32 (EXIT_FAILURE); /* mov eax, EXIT_FAILURE */
+  CODE (0xE9); rel32 (epilogue);
+  overflow = _text.size ();
+  CODE (0xBF); imm32 (rterr::stack_overflow); /* mov edi, code */
+  CODE (0x31, 0xF6);            /* xor esi, esi */
+  CODE (0xE9); rel32 (failure);
+  divide_by_zero = _text.size ();
+  CODE (0xBF); imm32 (rterr::divide_by_zero);
+  CODE (0x31, 0xF6);
+  CODE (0xE9); rel32 (failure);
+
+  /* --- the program: the outermost block and each PROC ... ENDPROC
+     range follow one another in the word stream, so we translate
+     them in a single sweep */
+  for (p = 0; p < n; p += length) {
+    length = opcode::length (code[p]);
+    if (!length || p + length > n) {
+      _errors.error (rterr::instruction, code[p], p);
+      return false;
+    }
+    _offsets[p] = _text.size ();
+    switch (code[p]) {
+    case opcode::add:
+      CODE (0x41, 0x8B, 0x04, 0x24,  /* mov eax, [r12] */
+	    0x49, 0x83, 0xEC, 0x04,  /* sub r12, 4 */
+	    0x41, 0x01, 0x04, 0x24); /* add [r12], eax */
+      break;
+    case opcode::and$:
+    case opcode::or$:
+      CODE (0x41, 0x8B, 0x04, 0x24,  /* mov eax, [r12] */
+	    0x49, 0x83, 0xEC, 0x04,  /* sub r12, 4 */
+	    0x41, 0x83, 0x3C, 0x24, 0x00); /* cmp dword [r12], 0 */
+      if (opcode::and$ == code[p]) {
+	CODE (0x74, 0x04);      /* je +4 */
+      } else {
+	CODE (0x75, 0x04);      /* jne +4 */
+      }
+      CODE (0x41, 0x89, 0x04, 0x24); /* mov [r12], eax */
+      break;
+    case opcode::arrow:
+      CODE (0x41, 0x8B, 0x04, 0x24,  /* mov eax, [r12] */
+	    0x49, 0x83, 0xEC, 0x04,  /* sub r12, 4 */
+	    0x85, 0xC0,              /* test eax, eax */
+	    0x0F, 0x84);             /* jz address */
+      link (code[p + 1]);
+      break;
+    case opcode::assign:
+      /* -- addresses at st[s-2n+1 .. s-n], values above them */
+      count = code[p + 1];
+      CODE (0x49, 0x81, 0xEC); imm32 (8 * count); /* sub r12, 8n */
+      for (int i = 1; i <= count; ++i) {
+	CODE (0x49, 0x63, 0x84, 0x24); /* movsxd rax, [r12+4i] */
+	imm32 (4 * i);
+	CODE (0x41, 0x8B, 0x8C, 0x24); /* mov ecx, [r12+4(i+n)] */
+	imm32 (4 * (i + count));
+	CODE (0x89, 0x0C, 0x83);       /* mov [rbx+rax*4], ecx */
+      }
+      break;
+    case opcode::bar:
+      CODE (0xE9); link (code[p + 1]); /* jmp address */
+      break;
+    case opcode::call:
+      CODE (0x49, 0x8D, 0x44, 0x24, 0x0C,  /* lea rax, [r12+12] */
+	    0x4C, 0x39, 0xF8,              /* cmp rax, r15 */
+	    0x0F, 0x87);                   /* ja overflow */
+      rel32 (overflow);
+      CODE (0x4C, 0x89, 0xE8);             /* mov rax, r13 */
+      for (level = code[p + 1]; level > 0; --level) {
+	CODE (0x48, 0x63, 0x04, 0x83);     /* movsxd rax, [rbx+rax*4] */
+      }
+      CODE (0x41, 0x89, 0x44, 0x24, 0x04,  /* mov [r12+4], eax */
+	    0x45, 0x89, 0x6C, 0x24, 0x08,  /* mov [r12+8], r13d */
+	    0x41, 0xC7, 0x44, 0x24, 0x0C); /* mov dword [r12+12], p+3 */
+      imm32 (p + 3);
+      CODE (0x49, 0x8D, 0x4C, 0x24, 0x04,  /* lea rcx, [r12+4] */
+	    0x48, 0x29, 0xD9,              /* sub rcx, rbx */
+	    0x48, 0xC1, 0xE9, 0x02,        /* shr rcx, 2 */
+	    0x49, 0x89, 0xCD,              /* mov r13, rcx */
+	    0x49, 0x83, 0xC4, 0x0C,        /* add r12, 12 */
+	    0xE9);                         /* jmp procedure */
+      link (code[p + 2]);
+      break;
+    case opcode::constant:
+      CODE (0x4D, 0x39, 0xFC, 0x0F, 0x83); /* cmp r12, r15; jae */
+      rel32 (overflow);
+      CODE (0x49, 0x83, 0xC4, 0x04,  /* add r12, 4 */
+	    0x41, 0xC7, 0x04, 0x24); /* mov dword [r12], value */
+      imm32 (code[p + 1]);
+      break;
+    case opcode::divide:
+    case opcode::modulo:
+      CODE (0x41, 0x8B, 0x0C, 0x24,  /* mov ecx, [r12] */
+	    0x49, 0x83, 0xEC, 0x04,  /* sub r12, 4 */
+	    0x85, 0xC9,              /* test ecx, ecx */
+	    0x0F, 0x84);             /* jz divide_by_zero */
+      rel32 (divide_by_zero);
+      CODE (0x41, 0x8B, 0x04, 0x24,  /* mov eax, [r12] */
+	    0x99,                    /* cdq */
+	    0xF7, 0xF9);             /* idiv ecx */
+      if (opcode::divide == code[p]) {
+	CODE (0x41, 0x89, 0x04, 0x24); /* mov [r12], eax */
+      } else {
+	CODE (0x41, 0x89, 0x14, 0x24); /* mov [r12], edx */
+      }
+      break;
+    case opcode::end_procedure:
+      CODE (0x4E, 0x8D, 0x64, 0xAB, 0xFC,  /* lea r12, [rbx+r13*4-4] */
+	    0x4A, 0x63, 0x44, 0xAB, 0x08,  /* movsxd rax, [rbx+r13*4+8] */
+	    0x4E, 0x63, 0x6C, 0xAB, 0x04,  /* movsxd r13, [rbx+r13*4+4] */
+	    0x41, 0xFF, 0x24, 0xC6);       /* jmp [r14+rax*8] */
+      break;
+    case opcode::end_program:
+      CODE (0x31, 0xC0, 0xE9);  /* xor eax, eax; jmp epilogue */
+      rel32 (epilogue);
+      break;
+    case opcode::equal:
+    case opcode::greater:
+    case opcode::less:
+      CODE (0x41, 0x8B, 0x04, 0x24,  /* mov eax, [r12] */
+	    0x49, 0x83, 0xEC, 0x04,  /* sub r12, 4 */
+	    0x41, 0x39, 0x04, 0x24); /* cmp [r12], eax */
+      switch (code[p]) {
+      case opcode::equal: CODE (0x0F, 0x94, 0xC0); break; /* sete al */
+      case opcode::less:  CODE (0x0F, 0x9C, 0xC0); break; /* setl al */
+      default:            CODE (0x0F, 0x9F, 0xC0); break; /* setg al */
+      }
+      CODE (0x0F, 0xB6, 0xC0,        /* movzx eax, al */
+	    0x41, 0x89, 0x04, 0x24); /* mov [r12], eax */
+      break;
+    case opcode::fi:
+      CODE (0xBE); imm32 (code[p + 1]);     /* mov esi, line */
+      CODE (0xBF); imm32 (rterr::if_fails); /* mov edi, code */
+      CODE (0xE9); rel32 (failure);
+      break;
+    case opcode::index:
+      /* -- 1 <= x <= bound, as one unsigned comparison of x - 1 */
+      CODE (0x41, 0x8B, 0x04, 0x24,  /* mov eax, [r12] */
+	    0x49, 0x83, 0xEC, 0x04,  /* sub r12, 4 */
+	    0x8D, 0x48, 0xFF,        /* lea ecx, [rax-1] */
+	    0x81, 0xF9);             /* cmp ecx, bound */
+      imm32 (code[p + 1] > 0 ? code[p + 1] : 0);
+      CODE (0x72, 0x0F);        /* jb +15 */
+      CODE (0xBE); imm32 (code[p + 2]);  /* mov esi, line */
+      CODE (0xBF); imm32 (rterr::range); /* mov edi, code */
+      CODE (0xE9); rel32 (failure);
+      CODE (0x41, 0x01, 0x0C, 0x24); /* add [r12], ecx */
+      break;
+    case opcode::minus:
+      CODE (0x41, 0xF7, 0x1C, 0x24); /* neg dword [r12] */
+      break;
+    case opcode::multiply:
+      CODE (0x41, 0x8B, 0x0C, 0x24,  /* mov ecx, [r12] */
+	    0x49, 0x83, 0xEC, 0x04,  /* sub r12, 4 */
+	    0x41, 0x8B, 0x04, 0x24,  /* mov eax, [r12] */
+	    0x0F, 0xAF, 0xC1,        /* imul eax, ecx */
+	    0x41, 0x89, 0x04, 0x24); /* mov [r12], eax */
+      break;
+    case opcode::not$:
+      CODE (0x41, 0x83, 0x3C, 0x24, 0x00, /* cmp dword [r12], 0 */
+	    0x0F, 0x94, 0xC0,             /* sete al */
+	    0x0F, 0xB6, 0xC0,             /* movzx eax, al */
+	    0x41, 0x89, 0x04, 0x24);      /* mov [r12], eax */
+      break;
+    case opcode::procedure:
+      CODE (0x49, 0x8D, 0x84, 0x24); /* lea rax, [r12+4*length] */
+      imm32 (4 * code[p + 1]);
+      CODE (0x4C, 0x39, 0xF8,        /* cmp rax, r15 */
+	    0x0F, 0x87);             /* ja overflow */
+      rel32 (overflow);
+      CODE (0x49, 0x89, 0xC4,        /* mov r12, rax */
+	    0xE9);                   /* jmp address */
+      link (code[p + 2]);
+      break;
+    case opcode::program:
+      CODE (0x45, 0x31, 0xED);       /* xor r13d, r13d */
+      CODE (0xC7, 0x03); imm32 (0);  /* mov dword [rbx], 0 */
+      CODE (0xC7, 0x43, 0x04); imm32 (0);
+      CODE (0xC7, 0x43, 0x08); imm32 (0);
+      if (2 + code[p + 1] > STACK_SIZE - 1) {
+	CODE (0xE9); rel32 (overflow);
+      } else {
+	CODE (0x4C, 0x8D, 0xA3);     /* lea r12, [rbx+4*(2+length)] */
+	imm32 (4 * (2 + code[p + 1]));
+	CODE (0xE9); link (code[p + 2]);
+      }
+      break;
+    case opcode::read:
+    case opcode::write:
+      CODE (0x49, 0x81, 0xEC); imm32 (4 * code[p + 1]); /* sub r12, 4n */
+      CODE (0x49, 0x8D, 0x74, 0x24, 0x04,  /* lea rsi, [r12+4] */
+	    0x48, 0x29, 0xDE,              /* sub rsi, rbx */
+	    0x48, 0xC1, 0xEE, 0x02,        /* shr rsi, 2 */
+	    0x48, 0x89, 0xEF);             /* mov rdi, rbp */
+      CODE (0xBA); imm32 (code[p + 1]);    /* mov edx, count */
+      if (opcode::read == code[p]) {
+	call (reinterpret_cast<void const*> (&jit::read));
+	CODE (0x85, 0xC0, 0x0F, 0x85);     /* test eax, eax; jnz */
+	rel32 (epilogue);
+      } else {
+	call (reinterpret_cast<void const*> (&jit::write));
+      }
+      break;
+    case opcode::subtract:
+      CODE (0x41, 0x8B, 0x04, 0x24,  /* mov eax, [r12] */
+	    0x49, 0x83, 0xEC, 0x04,  /* sub r12, 4 */
+	    0x41, 0x29, 0x04, 0x24); /* sub [r12], eax */
+      break;
+    case opcode::value:
+      CODE (0x49, 0x63, 0x04, 0x24,  /* movsxd rax, [r12] */
+	    0x8B, 0x04, 0x83,        /* mov eax, [rbx+rax*4] */
+	    0x41, 0x89, 0x04, 0x24); /* mov [r12], eax */
+      break;
+    case opcode::variable:
+      CODE (0x4D, 0x39, 0xFC, 0x0F, 0x83); /* cmp r12, r15; jae */
+      rel32 (overflow);
+      CODE (0x4C, 0x89, 0xE8);       /* mov rax, r13 */
+      for (level = code[p + 1]; level > 0; --level) {
+	CODE (0x48, 0x63, 0x04, 0x83); /* movsxd rax, [rbx+rax*4] */
+      }
+      CODE (0x48, 0x05); imm32 (code[p + 2]); /* add rax, displacement */
+      CODE (0x49, 0x83, 0xC4, 0x04,  /* add r12, 4 */
+	    0x41, 0x89, 0x04, 0x24); /* mov [r12], eax */
+      break;
+    }
+  }
+
+  /* --- now that every instruction has an address, patch the jumps */
+  for (fixup_vector::iterator it = _fixups.begin ();
+       it != _fixups.end (); ++it) {
+    if (it->second < 0 || it->second >= n
+	|| NO_OFFSET == _offsets[it->second]) {
+      _errors.error (rterr::instruction, it->second, it->second);
+      return false;
+    }
+    int d = static_cast<int> (_offsets[it->second] - (it->first + 4));
+    memcpy (&_text[it->first], &d, sizeof (d));
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- copy the text in to executable memory */
+bool jit::load () {
+#ifdef HAVE_JIT
+  long page = sysconf (_SC_PAGESIZE);
+  _size = (_text.size () + page - 1) / page * page;
+  _memory = mmap (NULL, _size, PROT_READ | PROT_WRITE,
+		  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (MAP_FAILED == _memory) {
+    _memory = NULL;
+    _errors.error (error::application::no_mem);
+    return false;
+  }
+  memcpy (_memory, &_text[0], _text.size ());
+  if (0 != mprotect (_memory, _size, PROT_READ | PROT_EXEC)) {
+    _errors.error (error::application::no_mem);
+    return false;
+  }
+  _addresses.assign (_words, static_cast<void*> (NULL));
+  for (size_t i = 0; i < _offsets.size (); ++i) {
+    if (NO_OFFSET != _offsets[i]) {
+      _addresses[i] = static_cast<unsigned char*> (_memory) + _offsets[i];
+    }
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+/* --------------------------------------------------------------------*/
+
+int jit::run () {
+  typedef int (*entry_type) (jit*, int*, void**, int*);
+  if (!translate () || !load ()) {
+    return EXIT_FAILURE;
+  }
+  entry_type entry = reinterpret_cast<entry_type> (_memory);
+  return entry (this, &_stack[0], &_addresses[0],
+		&_stack[STACK_SIZE - 1]);
+}
+
+/*----------------------------------------------------------------------
+  Helpers - called from the generated code
+----------------------------------------------------------------------*/
+
+/* --- READ: the addresses of the count variables start at st[first] */
+int jit::read (jit *self, int first, int count) {
+  int *st = &self->_stack[0];
+  for (int i = 0; i < count; ++i) {
+    if (!(self->_in >> st[st[first + i]])) {
+      self->_errors.error (rterr::input);
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- WRITE: the count values start at st[first] */
+void jit::write (jit *self, int first, int count) {
+  int *st = &self->_stack[0];
+  for (int i = 0; i < count; ++i) {
+    self->_out << st[first + i] << '\n';
+  }
+}
+
+/* --------------------------------------------------------------------*/
+
+void jit::fail (jit *self, int code, int argument) {
+  self->_errors.error (static_cast<rterr::code> (code), argument);
+}
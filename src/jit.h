@@ -0,0 +1,85 @@
+/*----------------------------------------------------------------------
+  File    : jit.h
+  Contents: PL machine to x86-64 translator (template JIT)
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#ifndef JIT_H
+#define JIT_H
+
+#include "error.h"
+#include <cstddef>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+/*----------------------------------------------------------------------
+  Preprocessor Definitions
+----------------------------------------------------------------------*/
+
+/* --- we only know how to generate code for x86-64 Linux */
+#if defined (__x86_64__) && defined (__linux__)
+#define HAVE_JIT 1
+#endif
+
+/*----------------------------------------------------------------------
+  Main Class - translates the assembled program in to native code, one
+  fixed template per instruction, and runs it.  The generated code
+  works on the same stack, with the same activation record layout, as
+  the interpreter, so the two always agree on a program's behaviour.
+----------------------------------------------------------------------*/
+
+class jit {
+
+private:
+
+  typedef std::vector<unsigned char>        text_type;
+  typedef std::vector<std::pair<size_t, int> > fixup_vector;
+
+  int const              *_code;  /* assembled program */
+  size_t                  _words; /* words in the program */
+  std::vector<int>        _stack; /* machine stack */
+  error_interface        &_errors; /* error manager */
+  std::istream           &_in;    /* input for READ */
+  std::ostream           &_out;   /* output for WRITE */
+  text_type               _text;  /* native code, as it is generated */
+  std::vector<size_t>     _offsets; /* code offset of each word */
+  std::vector<void*>      _addresses; /* native address of each word */
+  fixup_vector            _fixups; /* jumps to words not yet translated */
+  void                   *_memory; /* executable copy of the code */
+  size_t                  _size;  /* size of the executable mapping */
+
+  void put (unsigned char const*, size_t);
+  void imm32 (int);
+  void imm64 (void const*);
+  void rel32 (size_t);
+  void link (int);
+  void call (void const*);
+
+  bool translate ();
+  bool load ();
+
+  static int read (jit*, int, int);
+  static void write (jit*, int, int);
+  static void fail (jit*, int, int);
+
+public:
+
+  jit (int const*, size_t, error_interface&, std::istream&,
+       std::ostream&);
+  ~jit ();
+  int run ();
+
+  static bool supported ();
+
+};
+
+#endif
+
+/*----------------------------------------------------------------------
+  Emacs Configuration
+  Local Variables:
+  mode: C++
+  End:
+----------------------------------------------------------------------*/
@@ -0,0 +1,120 @@
+/*----------------------------------------------------------------------
+  File    : opcode.cc
+  Contents: PL machine operation codes
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "opcode.h"
+#include <cassert>
+#include <vector>
+
+/*----------------------------------------------------------------------
+  Constants
+----------------------------------------------------------------------*/
+
+static const struct {
+  const char *name;
+  int         length;
+} opcodes[] = {
+  { "ADD",      1 },
+  { "AND",      1 },
+  { "ARROW",    2 },
+  { "ASSIGN",   2 },
+  { "BAR",      2 },
+  { "CALL",     3 },
+  { "CONSTANT", 2 },
+  { "DIVIDE",   1 },
+  { "ENDPROC",  1 },
+  { "ENDPROG",  1 },
+  { "EQUAL",    1 },
+  { "FI",       2 },
+  { "GREATER",  1 },
+  { "INDEX",    3 },
+  { "LESS",     1 },
+  { "MINUS",    1 },
+  { "MODULO",   1 },
+  { "MULTIPLY", 1 },
+  { "NOT",      1 },
+  { "OR",       1 },
+  { "PROC",     3 },
+  { "PROG",     3 },
+  { "READ",     2 },
+  { "SUBTRACT", 1 },
+  { "VALUE",    1 },
+  { "VARIABLE", 3 },
+  { "WRITE",    2 }
+};
+
+/*----------------------------------------------------------------------
+  Functions
+----------------------------------------------------------------------*/
+
+const char* opcode::name (opcode::code c) {
+  assert (c >= add && c < last);
+  return opcodes[c].name;
+}
+
+/* --------------------------------------------------------------------*/
+
+int opcode::length (int c) {
+  if (c < add || c >= last) {
+    return 0;
+  }
+  return opcodes[c].length;
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- a program is only run once it is known to be sound: every word
+   the machine fetches as an operation must be one, with its operands
+   inside the program, and every jump, call and block must lead to the
+   start of an instruction.  The last instruction must not fall through
+   past the end.  An empty program fails at address 0 */
+int opcode::check (int const *code, size_t n) {
+  std::vector<bool> start (n);
+  int p, size = static_cast<int> (n), next = 0, last = 0, target;
+  if (0 == n) {
+    return 0;
+  }
+  for (p = 0; p < size; p = next) {
+    next = p + length (code[p]);
+    if (next == p || next > size) {
+      return p;
+    }
+    start[p] = true;
+    last     = p;
+  }
+  switch (code[last]) {
+  case bar:
+  case end_procedure:
+  case end_program:
+  case fi:
+    break;
+  default:
+    return last;
+  }
+  for (p = 0; p < size; p += length (code[p])) {
+    switch (code[p]) {
+    case arrow:
+    case bar:
+      target = code[p + 1];
+      break;
+    case call:
+    case procedure:
+    case program:
+      target = code[p + 2];
+      break;
+    default:
+      continue;
+    }
+    if (target < 0 || target >= size || !start[target]) {
+      return p;
+    }
+  }
+  return -1;
+}
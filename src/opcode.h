@@ -0,0 +1,70 @@
+/*----------------------------------------------------------------------
+  File    : opcode.h
+  Contents: PL machine operation codes
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#ifndef OPCODE_H
+#define OPCODE_H
+
+#include <cstddef>
+
+/*----------------------------------------------------------------------
+  Operation Codes - these are the numbers the assembler writes for
+  each instruction, so the order here must never change
+----------------------------------------------------------------------*/
+
+namespace opcode {
+  enum code {
+    add,                        /*  0: ADD */
+    and$,                       /*  1: AND */
+    arrow,                      /*  2: ARROW address */
+    assign,                     /*  3: ASSIGN count */
+    bar,                        /*  4: BAR address */
+    call,                       /*  5: CALL level address */
+    constant,                   /*  6: CONSTANT value */
+    divide,                     /*  7: DIVIDE */
+    end_procedure,              /*  8: ENDPROC */
+    end_program,                /*  9: ENDPROG */
+    equal,                      /* 10: EQUAL */
+    fi,                         /* 11: FI line */
+    greater,                    /* 12: GREATER */
+    index,                      /* 13: INDEX bound line */
+    less,                       /* 14: LESS */
+    minus,                      /* 15: MINUS */
+    modulo,                     /* 16: MODULO */
+    multiply,                   /* 17: MULTIPLY */
+    not$,                       /* 18: NOT */
+    or$,                        /* 19: OR */
+    procedure,                  /* 20: PROC length address */
+    program,                    /* 21: PROG length address */
+    read,                       /* 22: READ count */
+    subtract,                   /* 23: SUBTRACT */
+    value,                      /* 24: VALUE */
+    variable,                   /* 25: VARIABLE level displacement */
+    write,                      /* 26: WRITE count */
+    last
+  };
+
+  /* --- the mnemonic the assembler accepts for an operation */
+  const char* name (code);
+
+  /* --- number of machine words the instruction occupies, including
+     the operation code itself (0 for an invalid code) */
+  int length (int);
+
+  /* --- the address of the first instruction that would take the 
+     machine outside a program of the given size, or -1 if there is 
+     none (see opcode.cc) */
+  int check (int const*, size_t);
+}
+
+#endif
+
+/*----------------------------------------------------------------------
+  Emacs Configuration
+  Local Variables:
+  mode: C++
+  End:
+----------------------------------------------------------------------*/
@@ -10,7 +10,9 @@
 #endif 
 
 #include "error.h"
+#include "grammar.h"
 #include "parser.h"
+#include "trace.h"
 #include <cassert>
 #include <cstdarg>
 #include <cassert>
@@ -27,7 +29,6 @@ using std::cin;
 using std::cout;
 using std::cerr;
 using std::endl;
-using std::ifstream;
 using std::make_pair;
 using std::pair;
 using std::string;
@@ -41,125 +42,67 @@ using std::vector;
    
    SYMBOLS (COMMA, END, PLUS) 
 
-   Will return an STL set containing those token ids.  These procedures will 
-   also eliminate duplicates as well, thus:
+   Will return a token_set containing those token ids.  Duplicates are
+   harmless, thus:
 
    SYMBOLS (COMMA, END, PLUS, PLUS) = { COMMA, END, PLUS }
-   
+
+   When all the arguments are constants, the set is built by the compiler.
  */
 #define SYMBOLS(...) make_set(__VA_ARGS__)
 
 /* -- the following is only for syntactic sugar, it returns the set of
-   first symbols for a particular BNF rule */
-#define FIRST(x) _first_symbols[x]
-
-/* --- when debugging it may be useful to know where we are situated 
-   in the parse tree (use --enable-debug=true with the configure script
-   to enable this). */
-#ifdef NDEBUG
+   first symbols for a particular BNF rule (the sets are generated from
+   doc/pl-grammar.txt, see grammar.h) */
+#define FIRST(x) first_symbols[x]
+
+/* --- to see where the parser spends its effort, configure with 
+   --enable-trace: each handler (and each kind of statement) then counts
+   its calls, and the tokens and time it takes (see trace.h).  Without
+   it, the macros add nothing to the handlers at all. */
+#ifndef PARSER_TRACE
 #define BEGIN_NONTERMINAL_HANDLER(r,x)		\
   r parser::x NONTERMINAL_PARAMS {
 #define BEGIN_NONTERMINAL_HANDLER_X(r,x)	\
   r parser::x {
 #define END_NONTERMINAL_HANDLER }
 #define PREMATURE_END_NONTERMINAL_HANDLER
-#define  DEBUG_OUTPUT(x)
+#define BEGIN_STATEMENT(x)
+#define END_STATEMENT
+#define ENTER_RULE(x)
+#define LEAVE_RULE
+#define CONSUME_TOKEN
+#define TRACE_REPORT
 #else
-static int __indent = 0;
+#define TRACE_RULE(x)						\
+  { static trace::rule & _rule = trace::named (#x);		\
+    trace::enter (_rule); }
 #define BEGIN_NONTERMINAL_HANDLER(r,x)				\
   r parser::x NONTERMINAL_PARAMS {				\
-    char const *__fn = #x;					\
-    for (int __i = 0; __i < __indent; ++__i) {		\
-      cout << ' '; }						\
-    cout << "<" << __fn  << ">" << endl;			\
-    __indent++;
+    TRACE_RULE (x)
 #define BEGIN_NONTERMINAL_HANDLER_X(r,x)			\
   r parser::x {							\
-    char const *__fn = #x;					\
-    for (int __i = 0; __i < __indent; ++__i) {		\
-      cout << ' '; }						\
-    cout << "<" << __fn  << ">" << endl;			\
-    __indent++;
-#define END_NONTERMINAL_HANDLER				\
-  __indent--;						\
-  for (int __i = 0; __i < __indent; ++__i) {		\
-    cout << ' '; }					\
-  cout << "</" << __fn << ">" << endl; }		
-#define PREMATURE_END_NONTERMINAL_HANDLER {END_NONTERMINAL_HANDLER
-#define DEBUG_OUTPUT(x)						\
-  for (int __i = 0; __i < __indent; ++__i) {			\
-    cout << ' '; }						\
-  cout << "<" << x << " />\n";
+    TRACE_RULE (x)
+#define END_NONTERMINAL_HANDLER	trace::leave (); }
+#define PREMATURE_END_NONTERMINAL_HANDLER trace::leave ()
+#define BEGIN_STATEMENT(x) TRACE_RULE (x)
+#define END_STATEMENT trace::leave ()
+#define ENTER_RULE(x) TRACE_RULE (x)
+#define LEAVE_RULE trace::leave ()
+#define CONSUME_TOKEN trace::consume ()
+#define TRACE_REPORT trace::report ()
 #endif
 
 /*----------------------------------------------------------------------
   Constants
 ----------------------------------------------------------------------*/
 
-/* --- BNF rule names (for first set indexing) */
+/* --- an expression's operators, by how tightly they bind (see 
+   expression ()): the bottom of a bracketed expression, "&" and "|", 
+   comparisons, "+" and "-", the "-" before a first term, "*", "/" and 
+   "\", and "~" */
 enum {
-  PROGRAM, BLOCK, DEFINITION_PART, DEFINITION, CONSTANT_DEFINITION,
-  VARIABLE_DEFINITION1, VARIABLE_DEFINITION2, TYPE_SYMBOL, VARIABLE_LIST,
-  PROCEDURE_DEFINITION, STATEMENT_PART, STATEMENT, EMPTY_STATEMENT,
-  READ_STATEMENT, VARIABLE_ACCESS_LIST, WRITE_STATEMENT, EXPRESSION_LIST,
-  ASSIGNMENT_STATEMENT, PROCEDURE_STATEMENT, IF_STATEMENT, DO_STATEMENT,
-  GUARDED_COMMAND_LIST, GUARDED_COMMAND, EXPRESSION, PRIMARY_OPERATOR,
-  PRIMARY_EXPRESSION, RELATIONAL_OPERATOR, SIMPLE_EXPRESSION, ADDING_OPERATOR,
-  TERM, MULTIPLYING_OPERATOR, FACTOR, VARIABLE_ACCESS, INDEXED_SELECTOR,
-  CONSTANT, NUMERAL, BOOLEAN_SYMBOL, NAME, LAST_BNF_RULE
-};
-
-/* --- first sets (8 is just a magic number, it's the currently longest
-   set of first symbols) */
-static const int first_symbols[LAST_TOKEN][8] = {
-  /* PROGRAM */              { BEGIN, NONE }, 
-  /* BLOCK */                { BEGIN, NONE }, 
-  /* DEFINITION_PART */      { BOOLEAN, CONST, INTEGER, PROC, NONE }, 
-  /* DEFINITION */           { BOOLEAN, CONST, INTEGER, PROC, NONE }, 
-  /* CONSTANT_DEFINITION */  { CONST, NONE }, 
-  /* VARIABLE_DEFINITION1 */ { BOOLEAN, INTEGER, NONE }, 
-  /* VARIABLE_DEFINITION2 */ { IDENTIFIER, ARRAY, NONE }, 
-  /* TYPE_SYMBOL */          { BOOLEAN, INTEGER, NONE }, 
-  /* VARIABLE_LIST */        { IDENTIFIER, NONE }, 
-  /* PROCEDURE_DEFINITION */ { PROC, NONE }, 
-  /* STATEMENT_PART */       { SKIP, READ, WRITE, CALL, IF, DO, 
-			       IDENTIFIER, NONE }, 
-  /* STATEMENT */            { SKIP, READ, WRITE, CALL, IF, DO, 
-			       IDENTIFIER, NONE }, 
-  /* EMPTY_STATEMENT */      { SKIP, NONE }, 
-  /* READ_STATEMENT */       { READ, NONE }, 
-  /* VARIABLE_ACCESS_LIST */ { IDENTIFIER, NONE }, 
-  /* WRITE_STATEMENT */      { WRITE, NONE }, 
-  /* EXPRESSION_LIST */      { FALSE, TRUE, IDENTIFIER, LEFT_PAREN, 
-			       LOGICAL_NOT, MINUS, NUMBER, NONE }, 
-  /* ASSIGNMENT_STATEMENT */ { IDENTIFIER, NONE }, 
-  /* PROCEDURE_STATEMENT */  { CALL, NONE }, 
-  /* IF_STATEMENT */         { IF, NONE }, 
-  /* DO_STATEMENT */         { DO, NONE }, 
-  /* GUARDED_COMMAND_LIST */ { FALSE, TRUE, IDENTIFIER, LEFT_PAREN, 
-			       LOGICAL_NOT, MINUS, NUMBER, NONE }, 
-  /* GUARDED_COMMAND */      { FALSE, TRUE, IDENTIFIER, LEFT_PAREN, 
-			       LOGICAL_NOT, MINUS, NUMBER, NONE }, 
-  /* EXPRESSION */           { FALSE, TRUE, IDENTIFIER, LEFT_PAREN, 
-			       LOGICAL_NOT, MINUS, NUMBER, NONE },
-  /* PRIMARY_OPERATOR */     { LOGICAL_OR, LOGICAL_AND, NONE }, 
-  /* PRIMARY_EXPRESSION */   { FALSE, TRUE, IDENTIFIER, LEFT_PAREN, 
-			       LOGICAL_NOT, MINUS, NUMBER, NONE }, 
-  /* RELATIONAL_OPERATOR */  { EQUAL, GREATER_THAN, LESS_THAN, NONE }, 
-  /* SIMPLE_EXPRESSION */    { FALSE, TRUE, IDENTIFIER, LEFT_PAREN, 
-			       LOGICAL_NOT, MINUS, NUMBER, NONE }, 
-  /* ADDING_OPERATOR */      { PLUS, MINUS, NONE }, 
-  /* TERM */                 { FALSE, TRUE, IDENTIFIER, LEFT_PAREN, 
-			       LOGICAL_NOT, NUMBER, NONE }, 
-  /* MULTIPLYING_OPERATOR */ { MULTIPLY, DIVIDE, MODULO, NONE },
-  /* FACTOR */               { FALSE, TRUE, IDENTIFIER, LEFT_PAREN, 
-			       LOGICAL_NOT, NUMBER, NONE }, 
-  /* VARIABLE_ACCESS */      { IDENTIFIER, NONE }, 
-  /* INDEXED_SELECTOR */     { LEFT_BRACKET, NONE }, 
-  /* CONSTANT */             { FALSE, TRUE, IDENTIFIER, NUMBER, NONE }, 
-  /* NUMERAL */              { NUMBER, NONE }, 
-  /* BOOLEAN_SYMBOL */       { FALSE, TRUE, NONE }, 
-  /* NAME */                 { IDENTIFIER, NONE }
+  OPENING, PRIMARY, RELATIONAL, ADDING, NEGATION, MULTIPLYING, COMPLEMENT
 };
 
 /* --------------------------------------------------------------------*/
@@ -178,27 +121,24 @@ int parser::_next_label = 1;
   Main Methods
 ----------------------------------------------------------------------*/
 
-parser::parser (ifstream & s, symboltbl & t, error_interface & err,
-		 emitter_interface & emit)
-  : _emitter (emit), _errors (err), _scanner (s), _symbols (t), 
-    _null (token::null), _expected (NONE) {
-  unsigned int i, j;
-  /* Create the "first symbols" sets.  At this point using STL sets is a
-     little excessive, as there will never be duplicates; however, as we 
-     descend through the parse tree and use these to build follow sets 
-     and stop sets, the fact that sets forbid duplicates will become more 
-     important. */
-  for (i = 0; i < LAST_TOKEN; ++i) {
-    for (j = 0; NONE != first_symbols[i][j] && j < 8; ++j) {
-      _first_symbols[i].insert (
-	  static_cast<token_code> (first_symbols[i][j]));
-    }
-  }
+parser::parser (source const & s, symboltbl & t, arena & nodes, 
+		error_interface & err)
+  : _nodes (nodes), _errors (err), _scanner (s), _symbols (t), 
+    _next (0), _pretokenize (false), _lex_threads (1), _expected (NONE),
+    _statements (0) {
 }
 
 /* --------------------------------------------------------------------*/
 
+/* --- on to the next token: from the buffer, when the source has been
+   tokenized in advance (staying on END_OF_FILE once it is reached) */
 token_code parser::move () {
+  CONSUME_TOKEN;
+  if (_pretokenize) {
+    _token = _tokens[_next];
+    _next += _next + 1 < _tokens.size ();
+    return _token;
+  }
   return (_token = _scanner.next_token ());
 }
 
@@ -222,10 +162,10 @@ void parser::expect (token_code c, token_set const &stop) {
 
 /* --------------------------------------------------------------------*/
 
-void parser::expect (string &name, token_set const &stop) {
+void parser::expect (atom::id &name, token_set const &stop) {
   _expected = IDENTIFIER;       /* -- we always expect an ID */
   if (_expected == _token) {  /* ensure that we see it, */  
-    _token.value (name);      /* record the name and */
+    name = _token.spelling (); /* record the name and */
     move ();                    /* move on */
   } else {                      /* -- on failure, signal a syntax */
     syntax_error (stop); }    /* error to the user */
@@ -235,30 +175,28 @@ void parser::expect (string &name, token_set const &stop) {
 
 /* --------------------------------------------------------------------*/
 
-token & parser::define (string const & name, kind::code kind, 
-			 type::code type, int value, int size, 
-			 int displ, int start) {
-  if (!name.empty ()) { 
+symboltbl::handle parser::define (atom::id name, kind::code kind, 
+				  type::code type, int value, int size, 
+				  int displ, int start) {
+  if (atom::none != name) { 
     /* -- we are only concerned if the ID is defined withing the current
        scope (i.e. the *top*): if one exists, then the creation of a new one
        should *not* be allowed */
     symboltbl::iterator it = _symbols.find_top (name);
     if (it != _symbols.end ()) {
-      error (error::input::duplicate, it->second);
-      return it->second;    
+      error (error::input::duplicate, name);
+      return _symbols.lookup (name);
     } else {
 
       /* cout << "# " << name << ", level: " << _symbols.level () << "\n"; */
 
-      token tok (IDENTIFIER, kind, type, name, value, size,
-		  _symbols.level (), displ, start);
-      pair<symboltbl::iterator, bool> p = _symbols.insert (name, tok);
-      if (p.second) { 
-	return p.first->second; 
+      symbol s = { kind, type, value, size, _symbols.level (), displ, start };
+      if (_symbols.insert (name, s).second) { 
+	return _symbols.lookup (name); 
       }
     }
   }
-  return _null;
+  return symboltbl::none;
 }
 
 /* --------------------------------------------------------------------*/
@@ -266,78 +204,26 @@ token & parser::define (string const & name, kind::code kind,
 /* --- we never want to call the symbol table's find method directly
    because we would like to add symbols transparently to the table if 
    they do not exist. this means that as far as the searcher is concerned
-   anything they search for -- excluding the empty string -- will always
+   anything they search for -- excluding atom::none -- will always
    be found in the symbol table.  it's only a mater of whether it will
    issue a runtime error or not */
-token & parser::find (string const &name) {
-  symboltbl::iterator it = _symbols.find (name);
-  if (it != _symbols.end ()) { 
-    return it->second; 
+symboltbl::handle parser::find (atom::id name) {
+  symboltbl::handle h = _symbols.lookup (name);
+  if (symboltbl::none != h) { 
+    return h; 
   } 
-  token undefined (IDENTIFIER, name);
-  error (error::input::undefined_symbol, undefined);
+  error (error::input::undefined_symbol, name);
   suggest (name);
   return define (name, kind::undefined, type::universal);
 }
 
 /* --------------------------------------------------------------------*/
 
-std::string soundex(const std::string & input, const unsigned int n)
-{
-  static char lookup[] = {
-    '0', /* A */ '1', '2', '3', '0', '1', '2', '0', '0', '2', '2', '4',
-    '5', '5', '0', '1', '0', '6', '2', '3', '0', '1', '0', '2', '0', '2'
-  };
-  
-  // keep the first character intact
-  std::string result = input.substr(0, 1);
-
-  // compute value for each character thereafter
-  for (unsigned int i = 1; i < input.length(); i++) {
-    // skip non-alpha characters
-    if (!isalpha(input[i])) {
-      continue;
-    }
-
-    // uppercase the input value
-    const char lookupInput = islower(input[i]) ? toupper(input[i]) : input[i];
-    // lookup it's value
-    const char *lookupVal = &lookup[lookupInput-'A'];
-
-    // make sure this isn't a dupe value
-    if (result.find(lookupVal, 0) != 0 ) {
-      result.append(lookupVal);
-    }
-  }
-
-  // make sure we could actually encode something
-  if (result.length() >= n) {
-    return result.substr(0, n - 1);
-  }
-
-  // In cases of empty strings (or strings with no encodable
-  // characters), return Z000
-  return "Z000";
-}
-
-std::string soundex(const std::string &input)
-{
-  return soundex(input, 10);
-}
-
-/* --------------------------------------------------------------------*/
-
-void parser::suggest(std::string const & name)
-{
-  string s = soundex(name), t;
-  symboltbl::iterator it = _symbols.begin();
-  while (it != _symbols.end()) {
-    t = soundex(it->first);
-    if (s == t) {
-      token undefined (IDENTIFIER, it->first);
-      error (error::input::did_you_mean, undefined);
-      break;
-    }
+/* --- offer the closest defined name in scope, if there is one */
+void parser::suggest (atom::id name) {
+  atom::id similar = _symbols.suggest (name);
+  if (atom::none != similar) {
+    error (error::input::did_you_mean, similar);
   }
 }
 
@@ -368,19 +254,32 @@ void parser::error (error::input::code c) const {
 
 /* --------------------------------------------------------------------*/
 
+/* --- report a token by the text it was scanned from */
 void parser::error (error::input::code c, token const & t) const {
+  _errors.error (c, _scanner.text (t).c_str ());  
+}
+
+/* --------------------------------------------------------------------*/
+
+void parser::error (error::input::code c, atom::id name) const {
   string s;
-  t.value (s);
+  if (atom::none != name) {
+    s.assign (atom::name (name), atom::length (name));
+  }
   _errors.error (c, s.c_str ());  
 }
 
 /* --------------------------------------------------------------------*/
 
-void parser::error (error::input::code c, token const & t1,
-		     token const & t2) const {
-  string s1, s2;
-  t1.value (s1); t2.value (s2);
-  _errors.error (c, s1.c_str (), s2.c_str ());
+void parser::error (error::input::code c, char const * s) const {
+  _errors.error (c, s);  
+}
+
+/* --------------------------------------------------------------------*/
+
+void parser::error (error::input::code c, char const * s,
+		     token const & t) const {
+  _errors.error (c, s, _scanner.text (t).c_str ());
 }
 
 /* --------------------------------------------------------------------*/
@@ -394,11 +293,15 @@ void parser::syntax_error (token_set const & stop) {
       error (error::input::unexpected, _token);    
     } else {                    /* or (b) we may have been expecting 
 				   something else */
-      token expected (_expected, token::friendly_name (_expected));
-      error (error::input::expected_before, expected, _token);
+      error (error::input::expected_before, 
+	     token::friendly_name (_expected), _token);
     }
   }
   /* --- attempt to return the parser to a sane state --- */
+  if (_pretokenize && !stop.count (_token)) {
+    _next = _tokens.find (_next, stop); /* -- search the buffer's codes */
+    move ();                    /* for the next recognized symbol */
+  }
   while (!stop.count (_token)) { 
     move ();                    /* -- find the next recognized symbol */
   }
@@ -407,31 +310,36 @@ void parser::syntax_error (token_set const & stop) {
 /* --------------------------------------------------------------------*/
 
 /* Program = Block "." . */
-BEGIN_NONTERMINAL_HANDLER (void, program) {  
+BEGIN_NONTERMINAL_HANDLER (ast::program*, program) {  
   int begin  = new_label (), 
     variable = new_label ();
   _symbols.push ();             /* start a new scope */
-  _emitter.program (variable, begin);
-  block (begin, variable, SYMBOLS (PERIOD) + stop);
-  _emitter.end_program ();
+  ast::block *b = block (begin, variable, SYMBOLS (PERIOD) + stop);
   _symbols.pop ();              /* end the scope */
   expect (PERIOD, stop);
+  PREMATURE_END_NONTERMINAL_HANDLER;
+  return _nodes.make<ast::program> (_token.offset (), b);
 } END_NONTERMINAL_HANDLER;
 
 /* --------------------------------------------------------------------*/
 
 /* Block = "begin" DefinitionPart StatementPart "end" .  */  
-BEGIN_NONTERMINAL_HANDLER_X (void, block (int begin, int variable, 
-					    token_set const & stop))  {  
+BEGIN_NONTERMINAL_HANDLER_X (ast::block*, block (int begin, int variable, 
+						   token_set const & stop))  {  
   int count, displacement = 3;
+  unsigned opening = _token.offset (), body;
+  ast::list<ast::procedure> procedures;
+  ast::list<ast::statement> statements;
   expect (BEGIN, FIRST (DEFINITION_PART) + FIRST (STATEMENT_PART) 
 	   + SYMBOLS (END) + stop);
-  count = definition_part (displacement, FIRST (STATEMENT_PART) 
+  count = definition_part (displacement, procedures, FIRST (STATEMENT_PART) 
 			    + SYMBOLS (END) + stop);
-  _emitter.define_argument (variable, count);
-  _emitter.define_address (begin);
-  statement_part (SYMBOLS (END) + stop);  
+  body = _token.offset ();
+  statements = statement_part (SYMBOLS (END) + stop);  
   expect (END, stop);
+  PREMATURE_END_NONTERMINAL_HANDLER;
+  return _nodes.make<ast::block> (_token.offset (), procedures, statements,
+				  count, variable, begin, opening, body);
 } END_NONTERMINAL_HANDLER;
 
 /* --------------------------------------------------------------------*/
@@ -440,11 +348,13 @@ BEGIN_NONTERMINAL_HANDLER_X (void, block (int begin, int variable,
 /* Definition = ConstantDefinition | VariableDefinition	\
    | ProcedureDefinition . */
 BEGIN_NONTERMINAL_HANDLER_X 
-(int, definition_part (int &displacement, token_set const &stop)) {
+(int, definition_part (int &displacement, 
+		       ast::list<ast::procedure> &procedures,
+		       token_set const &stop)) {
   int variables = 0;
   syntax_check (FIRST (DEFINITION_PART) + stop);
   token_set extra = SYMBOLS (SEMICOLON) + stop;
-  while (_token >= BOOLEAN && _token <= PROC) {
+  while (FIRST (DEFINITION).count (_token)) {
     switch (_token) {
     case CONST:    
       constant_definition (extra);
@@ -454,11 +364,12 @@ BEGIN_NONTERMINAL_HANDLER_X
       variables += variable_definition (displacement, extra);
       break;
     case PROC:
-      procedure_definition (extra);
+      procedures.append (procedure_definition (extra));
       break;
     default:   
       /* --- for empty definitions -- also quiets the 'enumeration value
 	 'bla' not handled in switch' warnings */
+      PREMATURE_END_NONTERMINAL_HANDLER;
       return variables;
     }
     expect (SEMICOLON, FIRST (DEFINITION_PART) + stop);
@@ -472,7 +383,7 @@ BEGIN_NONTERMINAL_HANDLER_X
 
 /* ConstantDefinition = "const" ConstantName "=" Constant . */
 BEGIN_NONTERMINAL_HANDLER (void, constant_definition)  {    
-  string name;
+  atom::id name = atom::none;
   expect (CONST, SYMBOLS (IDENTIFIER) + SYMBOLS (EQUAL) 
 	   + FIRST (CONSTANT) + stop);    
   expect (name, SYMBOLS (EQUAL) + FIRST (CONSTANT) + stop);
@@ -488,14 +399,15 @@ BEGIN_NONTERMINAL_HANDLER (void, constant_definition)  {
 /* TypeSymbol =  "integer" | "Boolean" . */
 BEGIN_NONTERMINAL_HANDLER_X 
 (int, variable_definition (int &displacement, token_set const &stop)) {  
-  bool array; string name; constant_type c;
-  vector<string> variables; vector<string>::iterator it;
+  bool array; atom::id name; constant_type c;
+  vector<atom::id>::iterator it;
   kind::code kind; type::code type; int value = 0, size = 1; 
   /* TypeSymbol - type::code values based on token_code values */
   type = (BOOLEAN == _token ? type::boolean : type::integer);
   expect (static_cast<token_code> (type), 
 	   SYMBOLS (ARRAY) + FIRST (VARIABLE_LIST) + stop); 
   /* "array" VariableList ... */    
+  _names.clear ();              /* (the buffer is reused) */
   kind = kind::variable;
   if ( ( array = ( ARRAY == _token ) ) ) {
     kind = kind::array;
@@ -509,10 +421,11 @@ BEGIN_NONTERMINAL_HANDLER_X
       expect (COMMA, SYMBOLS (IDENTIFIER) + FIRST (CONSTANT) 
 	       + SYMBOLS (LEFT_BRACKET, RIGHT_BRACKET) + stop); 
     }
+    name = atom::none;
     expect (name, FIRST (VARIABLE_LIST) 
 	     + SYMBOLS (COMMA, LEFT_BRACKET, RIGHT_BRACKET) 
 	     + FIRST (CONSTANT) + stop);
-    variables.push_back (name);
+    _names.push_back (name);
   } while (COMMA == _token);
   /* if this is an array we will find: ... "[" Constant "]" . */
   if (array) {
@@ -527,7 +440,7 @@ BEGIN_NONTERMINAL_HANDLER_X
     expect (RIGHT_BRACKET, stop);
   }  
   /* finally, do the actual defining of the variables */
-  for (it = variables.begin (); it != variables.end (); ++it) {
+  for (it = _names.begin (); it != _names.end (); ++it) {
     /* cout << "# " << *it << ", kind: " << kind << ", type: " 
        << token::friendly_name ((token_code) type) << ", value: " 
        << value << ", displ: " << displacement << "\n"; 
@@ -536,14 +449,14 @@ BEGIN_NONTERMINAL_HANDLER_X
     displacement += size;
   }  
   PREMATURE_END_NONTERMINAL_HANDLER;
-  return variables.size () * size;
+  return _names.size () * size;
 } END_NONTERMINAL_HANDLER;
 
 /* --------------------------------------------------------------------*/
 
 /* ProcedureDefinition = "proc" ProcedureName Block . */
-BEGIN_NONTERMINAL_HANDLER (void, procedure_definition)  {  
-  string name;  
+BEGIN_NONTERMINAL_HANDLER (ast::procedure*, procedure_definition)  {  
+  atom::id name = atom::none;
   expect (PROC, SYMBOLS (IDENTIFIER) + FIRST (BLOCK) + stop);  
   expect (name, FIRST (BLOCK) + stop);      
   int proc     = new_label (),
@@ -551,11 +464,10 @@ BEGIN_NONTERMINAL_HANDLER (void, procedure_definition)  {
       begin    = new_label (); 
   define (name, kind::procedure, type::universal, 0, 0, 0, proc);
   _symbols.push ();             /* start a new scope */
-  _emitter.define_address (proc); /* record the procedure's address */
-  _emitter.procedure (variable, begin);
-  block (begin, variable, stop);
-  _emitter.end_procedure ();  
+  ast::block *b = block (begin, variable, stop);
   _symbols.pop ();              /* end the scope */
+  PREMATURE_END_NONTERMINAL_HANDLER;
+  return _nodes.make<ast::procedure> (_token.offset (), b, proc);
 } END_NONTERMINAL_HANDLER;
 
 /* --------------------------------------------------------------------*/
@@ -571,187 +483,288 @@ BEGIN_NONTERMINAL_HANDLER (void, procedure_definition)  {
 /* ProcedureStatement = "call" ProcedureName . */
 /* IfStatement = "if" GuardedCommandList "fi" . */
 /* DoStatement =  "do" GuardedCommandList "od" . */
-BEGIN_NONTERMINAL_HANDLER (void, statement_part)  {
-  syntax_check (FIRST (STATEMENT_PART) + stop);  
-  token_set extra = SYMBOLS (SEMICOLON) + stop;
-  int start, done, loop;
-  while ((_token >= SKIP && _token <= DO) 
-	  || IDENTIFIER == _token) {
-    string name; token tok;
-    parser::token_vector      vars;  parser::token_vector::iterator      it;
-    parser::expression_vector exprs; parser::expression_vector::iterator jt;
-    switch (_token) {
-    case SKIP: 
-      DEBUG_OUTPUT ("skip");
-      /* EmptyStatement = "skip" . */
-      expect (SKIP, extra);
-      break;    
-    case READ:
-      DEBUG_OUTPUT ("read");
-      /* ReadStatement = "read" VariableAccessList . */
-      expect (READ, FIRST (VARIABLE_ACCESS_LIST) + extra);
-      vars = variable_access_list (extra);
-      _emitter.read (vars.size ());
-      break;
-    case WRITE:
-      DEBUG_OUTPUT ("write");
-      /* WriteStatement = "write" ExpressionList . */
-      expect (WRITE, FIRST (EXPRESSION_LIST) + extra);
-      exprs = expression_list (extra);
-      _emitter.write (exprs.size ());
-      break;
-    case CALL:
-      DEBUG_OUTPUT ("call");
-      /* ProcedureStatement = "call" ProcedureName . */
-      expect (CALL, SYMBOLS (IDENTIFIER) + extra);      
-      expect (name, extra);
-      if (!name.empty ()) { 
-	/* -- here we look up the ID by name and check it's kind, if it is 
-	   a procedure then all is well, if it is not, then we have an 
-	   error or some sort or another */
-	tok = find (name);
-	if (tok.kind () != kind::procedure) {
-	  token proc (PROC, name);
-	  error (error::input::procedure, proc);
-	} else {
-	  _emitter.call (_symbols.level () - tok.level (), tok.start ());
-	  _symbols.push_storage (3);
+/* GuardedCommandList = GuardedCommand { "[]" GuardedCommand } . */
+/* GuardedCommand = Expression "->" StatementPart . */
+
+/* --- statements nest through if and do statements to any depth, so
+   they are parsed on an explicit stack, _nestings, rather than by a 
+   handler for each rule calling the next: an "if" or a "do" saves the
+   statement part it is in and starts on its first guarded command (see
+   nest ()), and the end of a guarded command's statements goes back to
+   it, for the next command or the "fi" or "od".  The steps are taken 
+   in the order a descent would take them, with the same stop sets, so
+   the messages are the same.  Procedures nest by recursion still, since
+   each opens a scope (see procedure_definition ()) */
+BEGIN_NONTERMINAL_HANDLER (ast::list<ast::statement>, statement_part)  {
+  ast::list<ast::statement> statements;
+  token_set part = stop;        /* the innermost statement part's */
+  size_t base = _nestings.size ();
+  syntax_check (FIRST (STATEMENT_PART) + part);  
+  for (;;) {
+    while (FIRST (STATEMENT).count (_token)) {
+      token_set extra = SYMBOLS (SEMICOLON) + part;
+      atom::id name = atom::none; symboltbl::handle h;
+      ast::list<ast::expression> vars, exprs;
+      ast::expression *v, *e;
+      ast::statement *s = NULL;
+      switch (_token) {
+      case SKIP: 
+	BEGIN_STATEMENT (empty_statement);
+	/* EmptyStatement = "skip" . */
+	expect (SKIP, extra);
+	s = _nodes.make<ast::empty> (_token.offset ());
+	break;    
+      case READ:
+	BEGIN_STATEMENT (read_statement);
+	/* ReadStatement = "read" VariableAccessList . */
+	expect (READ, FIRST (VARIABLE_ACCESS_LIST) + extra);
+	vars = variable_access_list (extra);
+	s = _nodes.make<ast::read> (_token.offset (), vars);
+	break;
+      case WRITE:
+	BEGIN_STATEMENT (write_statement);
+	/* WriteStatement = "write" ExpressionList . */
+	expect (WRITE, FIRST (EXPRESSION_LIST) + extra);
+	exprs = expression_list (extra);
+	s = _nodes.make<ast::write> (_token.offset (), exprs);
+	break;
+      case CALL:
+	BEGIN_STATEMENT (procedure_statement);
+	/* ProcedureStatement = "call" ProcedureName . */
+	expect (CALL, SYMBOLS (IDENTIFIER) + extra);      
+	expect (name, extra);
+	if (atom::none != name) { 
+	  /* -- here we look up the ID by name and check it's kind, if it is 
+	     a procedure then all is well, if it is not, then we have an 
+	     error or some sort or another */
+	  h = find (name);
+	  if (_symbols[h].kind != kind::procedure) {
+	    error (error::input::procedure, name);
+	  } else {
+	    s = _nodes.make<ast::call> (_token.offset (), 
+					_symbols.level () - _symbols[h].level,
+					_symbols[h].start);
+	  }
 	}
-      }
-      break;
-    case IF:
-      /*
-	expect (IF);
-	type = expression ()
-	check_types (type, type::boolean);
-	expect (THEN);
-	new_label (label1);
-	emit (DO, label1);
-	pop_storage (1);
-	statement ();
-	if current_symbol == ELSE then
-	  expect (ELSE);
-	  new_label (label2);
-	  emit (GOTO, label2);
+	break;
+      case IF:
+	/*
+	  expect (IF);
+	  type = expression ()
+	  check_types (type, type::boolean);
+	  expect (THEN);
+	  new_label (label1);
+	  emit (DO, label1);
+	  pop_storage (1);
+	  statement ();
+	  if current_symbol == ELSE then
+	    expect (ELSE);
+	    new_label (label2);
+	    emit (GOTO, label2);
+	    emit (defaddr, label1);
+	    statement ();
+	    emit (defaddr, label2);
+	  else
+	    emit (defaddr, label1);
+	  end;
+
+  n-1: ...        
+    n: found := true;
+  n+1: if found -> write 1; []
+  n+2:  ~found -> write 0; 
+  n+3: fi
+  n+4: ...
+        
+	  ARROW    L_0
+	  CONSTANT 1
+	  WRITE    1
+	  BAR      L_NEXT
+     L_0: ARROW    L_1
+	  CONSTANT 0
+	  WRITE    1
+	  BAR      L_NEXT
+     L_1: F1       n+1
+  L_NEXT: ... next code ...
+	 */
+
+	BEGIN_STATEMENT (if_statement);
+	/* IfStatement = "if" GuardedCommandList "fi" . */      
+	expect (IF, FIRST (GUARDED_COMMAND_LIST) + SYMBOLS (FI) + extra);
+	nest (IF, statements, part);
+	continue;
+      case DO:
+	/*
+	  new_label (label1);
 	  emit (defaddr, label1);
+	  expect (WHILE);
+	  type = expression ();
+	  check_type (type, type::boolean);
+	  expect (DO);
+	  new_label (label2);
+	  emit (DO, label2);
+	  pop_storage (1);
 	  statement ();
+	  emit (GOTO, label1);
 	  emit (defaddr, label2);
-	else
-	  emit (defaddr, label1);
-	end;
-
-n-1: ...        
-  n: found := true;
-n+1: if found -> write 1; []
-n+2:  ~found -> write 0; 
-n+3: fi
-n+4: ...
-        
-        ARROW    L_0
-        CONSTANT 1
-        WRITE    1
-        BAR      L_NEXT
-   L_0: ARROW    L_1
-        CONSTANT 0
-        WRITE    1
-        BAR      L_NEXT
-   L_1: F1       n+1
-L_NEXT: ... next code ...
-       */
-
-      DEBUG_OUTPUT ("if");
-      /* IfStatement = "if" GuardedCommandList "fi" . */      
-      expect (IF, FIRST (GUARDED_COMMAND_LIST) + SYMBOLS (FI) + extra);
-      start = new_label (), done = new_label ();
-      guarded_command_list (start, done, SYMBOLS (FI) + extra);
-      _emitter.define_address (start);
-      _emitter.fi (line ());      
-      _emitter.define_address (done);
-      expect (FI, extra);
-      break;
-    case DO:
-      /*
-	new_label (label1);
-	emit (defaddr, label1);
-	expect (WHILE);
-	type = expression ();
-	check_type (type, type::boolean);
-	expect (DO);
-	new_label (label2);
-	emit (DO, label2);
-	pop_storage (1);
-	statement ();
-	emit (GOTO, label1);
-	emit (defaddr, label2);
-
-	...        
-ok := true;
-do ok -> 
-  ok := (i < 10);
-  write 1;
-od
-...
+
+	  ...        
+  ok := true;
+  do ok -> 
+    ok := (i < 10);
+    write 1;
+  od
+  ...
         
-   L_0: ARROW    L_NEXT
-        ...      // evaluate ==> ok := (i < 10);
-		 CONSTANT 1
-        WRITE    1
-        BAR      L_0   
-L_NEXT: ... next code ...
+     L_0: ARROW    L_NEXT
+	  ...      // evaluate ==> ok := (i < 10);
+		   CONSTANT 1
+	  WRITE    1
+	  BAR      L_0   
+  L_NEXT: ... next code ...
 	
-       */
-      DEBUG_OUTPUT ("do");
-      /* DoStatement = "do" GuardedCommandList "od" . */
-      expect (DO, FIRST (GUARDED_COMMAND_LIST) + SYMBOLS (OD) + extra);
-      start = new_label (), loop = new_label ();
-      _emitter.define_address (loop);
-      guarded_command_list (start, loop, SYMBOLS (OD) + extra);
-      _emitter.define_address (start);
-      expect (OD, extra);
-      break;
-    case IDENTIFIER: /* ASSIGN */
-      DEBUG_OUTPUT ("assign");
-      /* AssignmentStatement = VariableAccessList ":=" ExpressionList . */    
-      vars = variable_access_list (SYMBOLS (ASSIGN) 
-				    + FIRST (EXPRESSION_LIST) 
-				    + extra);
-      expect (ASSIGN, FIRST (EXPRESSION_LIST) + extra);
-      exprs = expression_list (extra);      
-      /* -- check types involved in the assignment statement */
-      if (vars.size () == exprs.size ()) {
-	for (it = vars.begin (), jt = exprs.begin (); 
-	      it != vars.end (); ++it, ++jt) {
-	  type_check (*jt, it->type ());	  
+	 */
+	BEGIN_STATEMENT (do_statement);
+	/* DoStatement = "do" GuardedCommandList "od" . */
+	expect (DO, FIRST (GUARDED_COMMAND_LIST) + SYMBOLS (OD) + extra);
+	nest (DO, statements, part);
+	continue;
+      case IDENTIFIER: /* ASSIGN */
+	BEGIN_STATEMENT (assignment_statement);
+	/* AssignmentStatement = VariableAccessList ":=" ExpressionList . */    
+	vars = variable_access_list (SYMBOLS (ASSIGN) 
+				      + FIRST (EXPRESSION_LIST) 
+				      + extra);
+	expect (ASSIGN, FIRST (EXPRESSION_LIST) + extra);
+	exprs = expression_list (extra);      
+	/* -- check types involved in the assignment statement */
+	if (vars.count == exprs.count) {
+	  for (v = vars.first, e = exprs.first; v; v = v->next, e = e->next) {
+	    type::code type = e->type;
+	    type_check (type, v->type);
+	  }
+	} else {
+	  /* -- unbalanced assignment statement (this is a a bit ad-hoc, but 
+	   it will do for now ... it just tells the user which side is heavy */   
+	  error (error::input::balance, 
+		 vars.count > exprs.count ? "lhs" : "rhs");
 	}
-	_emitter.assign (vars.size ());
-	_symbols.pop_storage (vars.size () + 1);
-      } else {
-	/* -- unbalanced assignment statement (this is a a bit ad-hoc, but 
-	 it will do for now ... it just tells the user which side is heavy */	
-	token heavy (IDENTIFIER, vars.size () > exprs.size () 
-		      ? "lhs" : "rhs");
-	error (error::input::balance, heavy);
-      }
-      break;
-    default:
-      /* ERROR! - can't get here */
-      assert (0);
-      break;
+	s = _nodes.make<ast::assignment> (_token.offset (), vars, exprs);
+	break;
+      default:
+	/* ERROR! - can't get here */
+	assert (0);
+	break;
+      }  
+      end_statement (s, statements, part);
     }  
-    expect (SEMICOLON, FIRST (STATEMENT_PART) + stop);    
-  }  
+    if (base == _nestings.size ()) {
+      break;                    /* (the end of the outermost part) */
+    }
+    /* --- the end of a guarded command's statements: it is complete, so
+       go on to the next command, or finish the if or do statement */
+    LEAVE_RULE;                 /* (statement_part) */
+    nesting & n = _nestings.back ();
+    n.commands.append (_nodes.make<ast::guarded_command> (_token.offset (), 
+							  n.guard, statements,
+							  n.entry, n.label, 
+							  n.offset, n.arrow));
+    LEAVE_RULE;                 /* (guarded_command) */
+    if (GUARD_SEPARATOR == _token) {
+      expect (GUARD_SEPARATOR, FIRST (GUARDED_COMMAND) + n.commands_stop);
+      guarded_command (n.commands_stop, statements, part);
+      continue;
+    }
+    LEAVE_RULE;                 /* (guarded_command_list) */
+    ast::statement *s;
+    statements = n.statements;
+    part       = n.stop;
+    if (IF == n.kind) {
+      s = _nodes.make<ast::if_statement> (_token.offset (), n.commands, 
+					   n.end, line ());
+    } else {
+      s = _nodes.make<ast::do_statement> (_token.offset (), n.commands, 
+					   n.end);
+    }
+    expect (IF == n.kind ? FI : OD, SYMBOLS (SEMICOLON) + part);
+    _nestings.pop_back ();
+    end_statement (s, statements, part);
+  }
+  PREMATURE_END_NONTERMINAL_HANDLER;
+  return statements;
 } END_NONTERMINAL_HANDLER;
 
 /* --------------------------------------------------------------------*/
 
+/* --- start on an if or do statement's guarded commands, saving the
+   statement part it is in: the "fi" or "od" that ends it, as well as
+   the ";" after that, stops each command's statements */
+void parser::nest (token_code kind, ast::list<ast::statement> & statements,
+		   token_set & part) {
+  nesting n;
+  n.kind          = kind;
+  n.stop          = part;
+  n.statements    = statements;
+  n.commands_stop = SYMBOLS (IF == kind ? FI : OD, SEMICOLON) + part;
+  n.label         = new_label ();
+  n.end           = new_label ();
+  _nestings.push_back (n);
+  ENTER_RULE (guarded_command_list);
+  guarded_command (SYMBOLS (GUARD_SEPARATOR) + n.commands_stop, statements,
+		   part);
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- a guarded command up to its "->", after which the parse goes on 
+   in the statement part it guards */
+void parser::guarded_command (token_set const & stop, 
+			      ast::list<ast::statement> & statements,
+			      token_set & part) {
+  ENTER_RULE (guarded_command);
+  nesting & n = _nestings.back ();
+  n.entry  = n.label;
+  n.offset = _token.offset ();
+  n.guard  = expression (SYMBOLS (GUARD_POINT) + FIRST (STATEMENT_PART) 
+			 + stop);
+  /* -- ensure that the expression given before the arrow is of type
+     boolean; otherwise, issue an error to the user */
+  if (type::boolean != n.guard->type && type::universal != n.guard->type) {
+    error (error::input::boolean);
+  }  
+  n.label = new_label ();
+  n.arrow = _token.offset ();
+  expect (GUARD_POINT, FIRST (STATEMENT_PART) + stop);
+  ENTER_RULE (statement_part);
+  statements = ast::list<ast::statement> ();
+  part       = stop;
+  syntax_check (FIRST (STATEMENT_PART) + part);  
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- a statement is complete: add it to its statement part, which it
+   must be separated from the rest of by a ";" */
+void parser::end_statement (ast::statement *s, 
+			    ast::list<ast::statement> & statements,
+			    token_set const & part) {
+  END_STATEMENT;
+  if (s) {
+    statements.append (s);
+  }
+  ++_statements;
+  expect (SEMICOLON, FIRST (STATEMENT_PART) + part);    
+}
+
+/* --------------------------------------------------------------------*/
+
 /* VariableAccessList = VariableAccess { "," VariableAccess } . */
-BEGIN_NONTERMINAL_HANDLER (parser::token_vector, variable_access_list) {
-  parser::token_vector vars;
+BEGIN_NONTERMINAL_HANDLER (ast::list<ast::expression>, variable_access_list) {
+  ast::list<ast::expression> vars;
   do { 
     if (COMMA == _token) {
       expect (COMMA, FIRST (VARIABLE_ACCESS) + stop);
     }
-    vars.push_back (variable_access (SYMBOLS (COMMA) + stop));    
+    vars.append (variable_access (SYMBOLS (COMMA) + stop));    
   } while  (COMMA == _token);
   PREMATURE_END_NONTERMINAL_HANDLER;
   return vars;
@@ -760,36 +773,38 @@ BEGIN_NONTERMINAL_HANDLER (parser::token_vector, variable_access_list) {
 /* --------------------------------------------------------------------*/
 
 /* VariableAccess = VariableName [ IndexedSelector ] . */
-BEGIN_NONTERMINAL_HANDLER (token, variable_access) {
-  string name; token tok;
+BEGIN_NONTERMINAL_HANDLER (ast::identifier*, variable_access) {
+  atom::id name = atom::none; symboltbl::handle h;
+  token t = _token;
   expect (name, FIRST (INDEXED_SELECTOR) + stop);  
-  tok = find (name);
+  h = find (name);
 
   /* cout << "# " << name 
-     << ", level: " << tok.level () 
+     << ", level: " << _symbols[h].level 
      << ", current block level: " << _symbols.level () << "\n"; */
   
-  _emitter.variable (_symbols.level () - tok.level (), 
-		      tok.displacement ());
-  _symbols.push_storage (1);
   /* IndexedSelector = "[" Expression "]" . */
   if (LEFT_BRACKET == _token) {         
-    indexed_selector (tok.size (), stop);
+    unsigned selector = _token.offset ();
+    int      line     = parser::line ();
+    ast::expression *index = indexed_selector (stop);
+    PREMATURE_END_NONTERMINAL_HANDLER;
+    return variable (t, h, index, line, selector);
   }   
   PREMATURE_END_NONTERMINAL_HANDLER;
-  return tok;  
+  return variable (t, h);
 } END_NONTERMINAL_HANDLER;
 
 /* --------------------------------------------------------------------*/
 
 /* ExpressionList = Expression { "," Expression } . */
-BEGIN_NONTERMINAL_HANDLER (parser::expression_vector, expression_list) {
-  parser::expression_vector exprs;
+BEGIN_NONTERMINAL_HANDLER (ast::list<ast::expression>, expression_list) {
+  ast::list<ast::expression> exprs;
   do { 
     if (COMMA == _token) {
       expect (COMMA, FIRST (EXPRESSION) + stop); 
     }
-    exprs.push_back (expression (SYMBOLS (COMMA) + stop));
+    exprs.append (expression (SYMBOLS (COMMA) + stop));
   } while (COMMA == _token);
   PREMATURE_END_NONTERMINAL_HANDLER;
   return exprs;  
@@ -797,288 +812,295 @@ BEGIN_NONTERMINAL_HANDLER (parser::expression_vector, expression_list) {
 
 /* --------------------------------------------------------------------*/
 
-/* GuardedCommandList = GuardedCommand { "[]" GuardedCommand } . */
-BEGIN_NONTERMINAL_HANDLER_X (void, guarded_command_list (int &start, 
-							   int go_to, 
-							   token_set const
-							   &stop)) {
-  guarded_command (start, go_to, SYMBOLS (GUARD_SEPARATOR) + stop);
-  while (GUARD_SEPARATOR == _token) {
-    expect (GUARD_SEPARATOR, FIRST (GUARDED_COMMAND) + stop);
-    guarded_command (start, go_to, stop);
+/* Expression = PrimaryExpression { PrimaryOperator PrimaryExpression } . */
+/* PrimaryOperator = "&" | "|" . */
+/* PrimaryExpression = SimpleExpression [ RelationalOperator	\
+   SimpleExpression ] . */
+/* RelationalOperator = "<" | "=" | ">" . */
+/* SimpleExpression = [ "-" ] Term { AddingOperator Term } . */
+/* Term = Factor { MultiplyingOperator Factor } . */
+/* Factor = Constant | VariableAccess | "(" Expression ")" | "~" Factor . */
+
+/* --- expressions are parsed by precedence climbing, on an explicit 
+   stack of operands, operators and bracketed expressions, rather than
+   by a method per level: nesting takes stack space (and not native 
+   stack), and an operand takes the same few steps however deep it is.
+   The order of the steps is that of a descent through the levels, so 
+   the same stop sets are checked at the same tokens, and the same type
+   checks are made in the same order, as the grammar above says.  There
+   are three states: at the start of a simple expression (where a "-"
+   may be), at the start of a factor, and after a complete factor, from
+   where the levels are climbed back up until an operator continues
+   one of them */
+BEGIN_NONTERMINAL_HANDLER (ast::expression*, expression)  {
+  enum { SIMPLE, FACTOR, DONE } state = SIMPLE;
+  atom::id name; symboltbl::handle h; token t; constant_type k;
+  open (END_OF_FILE, stop);
+  for (;;) {
+    context const & c = _contexts.back ();
+    switch (state) {
+    case SIMPLE:
+      /* [ "-" ] Term */
+      syntax_check (c.simple);
+      if (MINUS == _token) {
+	push (NEGATION);
+	expect (MINUS, c.term);
+      }
+      /* no break */
+    case FACTOR:
+      /* "~" Factor */
+      if (LOGICAL_NOT == _token) {
+	push (COMPLEMENT);
+	expect (LOGICAL_NOT, c.factor);
+	state = FACTOR;
+	continue;
+      }
+      /* "(" Expression ")" */
+      if (LEFT_PAREN == _token) {
+	expect (LEFT_PAREN, c.factor + SYMBOLS (RIGHT_PAREN));
+	open (RIGHT_PAREN, c.factor + SYMBOLS (RIGHT_PAREN));
+	state = SIMPLE;
+	continue;
+      }
+      /* Constant | VariableAccess: a name may be either (see constant ()),
+	 and an array's IndexedSelector (= "[" Expression "]" .) is a 
+	 bracketed expression of its own */
+      t = _token;
+      if (IDENTIFIER == _token 
+	  && _symbols[find (_token.spelling ())].kind != kind::constant) {
+	name = atom::none;
+	expect (name, c.factor + SYMBOLS (LEFT_BRACKET));
+	h = find (name);
+	if (LEFT_BRACKET == _token) {
+	  token_set inner = c.factor + SYMBOLS (RIGHT_BRACKET);
+	  open (RIGHT_BRACKET, inner, t, h); /* (c moves) */
+	  expect (LEFT_BRACKET, inner);
+	  state = SIMPLE;
+	  continue;
+	}
+	push (variable (t, h));
+      } else {
+	k = constant (c.factor);
+	push (_nodes.make<ast::constant> (_token.offset (), t, k.second, 
+					  k.first));
+      }
+      state = DONE;
+      /* no break */
+    case DONE:
+      /* -- a factor is complete: apply the "~"s before it */
+      while (COMPLEMENT == _operators.back ().precedence) {
+	reduce_unary (type::boolean);
+      }
+      /* MultiplyingOperator (= "*" | "/" | "\" .) Factor */
+      if (MULTIPLYING == _operators.back ().precedence) {
+	reduce ();
+      }
+      if (_token >= MULTIPLY && _token <= MODULO) {
+	push (MULTIPLYING);
+	expect (_token, c.term);
+	syntax_check (c.factor);
+	state = FACTOR;
+	continue;
+      }
+      /* -- a term is complete: negate the first; AddingOperator (= "+" | 
+	 "-" .) Term */
+      if (ADDING == _operators.back ().precedence) {
+	reduce ();
+      } else {
+	if (NEGATION == _operators.back ().precedence) {
+	  reduce_unary (type::integer);
+	}
+	syntax_check (c.term);
+      }
+      if (PLUS == _token || MINUS == _token) {
+	push (ADDING);
+	expect (_token, c.simple);
+	state = FACTOR;
+	continue;
+      }
+      /* -- a simple expression is complete: RelationalOperator 
+	 SimpleExpression */
+      if (RELATIONAL == _operators.back ().precedence) {
+	reduce ();
+      } else {
+	syntax_check (c.simple);
+      }
+      if (_token >= EQUAL && _token <= LESS_THAN) {
+	push (RELATIONAL);
+	expect (_token, c.primary);
+	state = SIMPLE;
+	continue;
+      }
+      /* -- a primary expression is complete (a comparison is Boolean from 
+	 here on, whatever its operands were): PrimaryOperator 
+	 PrimaryExpression */
+      _operands.back ().type = _operands.back ().node->type;
+      if (PRIMARY == _operators.back ().precedence) {
+	reduce ();
+      } else {
+	syntax_check (c.primary);
+      }
+      if (LOGICAL_AND == _token || LOGICAL_OR == _token) {
+	push (PRIMARY);
+	expect (_token, c.any);
+	state = SIMPLE;
+	continue;
+      }
+      /* -- a bracketed expression is complete, and is a factor of the
+	 one around it */
+      if (!close ()) {
+	PREMATURE_END_NONTERMINAL_HANDLER;
+	ast::expression *e = _operands.back ().node;
+	_operands.pop_back ();
+	return e;
+      }
+      break;
+    }
   }
 } END_NONTERMINAL_HANDLER;
 
 /* --------------------------------------------------------------------*/
 
-/* GuardedCommand = Expression "->" StatementPart . */
-BEGIN_NONTERMINAL_HANDLER_X (void, guarded_command (int &this_label, 
-						      int go_to, 
-						      token_set const 
-						      &stop)) {
-  _emitter.define_address (this_label);
-  type::code type = expression (SYMBOLS (GUARD_POINT) 
-				 + FIRST (STATEMENT_PART) + stop);
-  /* -- ensure that the expression given before the arrow is of type
-     boolean; otherwise, issue an error to the user */
-  if (type::boolean != type && type::universal != type) {
-    error (error::input::boolean);
-  }  
-  this_label = new_label ();
-  _emitter.arrow (this_label);
-  expect (GUARD_POINT, FIRST (STATEMENT_PART) + stop);
-  statement_part (stop);
-  _emitter.bar (go_to);
-} END_NONTERMINAL_HANDLER;
+/* --- start a bracketed expression, working out the stop sets of each 
+   of its levels once: an index also remembers its array */
+void parser::open (token_code closer, token_set const & stop, 
+		   token const & name, symboltbl::handle array) {
+  context c;
+  c.closer   = closer;
+  c.any      = FIRST (PRIMARY_EXPRESSION) + stop;
+  c.primary  = FIRST (PRIMARY_OPERATOR) + c.any;
+  c.simple   = FIRST (RELATIONAL_OPERATOR) + FIRST (SIMPLE_EXPRESSION) 
+    + c.primary;
+  c.term     = FIRST (ADDING_OPERATOR) + FIRST (TERM) + c.simple;
+  c.factor   = FIRST (MULTIPLYING_OPERATOR) + FIRST (FACTOR) + c.term;
+  c.name     = name;
+  c.array    = array;
+  c.line     = RIGHT_BRACKET == closer ? line () : 0;
+  c.selector = _token.offset ();
+  _contexts.push_back (c);
+  push (OPENING);
+}
 
 /* --------------------------------------------------------------------*/
 
-/* Expression = PrimaryExpression { PrimaryOperator PrimaryExpression } . */
-/* PrimaryOperator = "&" | "|" . */
-BEGIN_NONTERMINAL_HANDLER (type::code, expression)  {
-  type::code t1, t2; token_code code;
-  t1 = primary_expression (FIRST (PRIMARY_OPERATOR) 
-			    + FIRST (PRIMARY_EXPRESSION) + stop);
-  /* PrimaryOperator (= "&" | "|" .) */  
-  syntax_check (FIRST (PRIMARY_OPERATOR) 
-		 + FIRST (PRIMARY_EXPRESSION) + stop); 
-  while (LOGICAL_AND == _token || LOGICAL_OR == _token) {
-    code = _token;
-    expect (_token, FIRST (PRIMARY_EXPRESSION) + stop);
-    t2 = primary_expression (FIRST (PRIMARY_OPERATOR) 
-			      + FIRST (PRIMARY_EXPRESSION) + stop);     
-    type_check (t1, t2);
-    switch (code) {
-    case LOGICAL_AND: _emitter.and$ (); break;
-    case  LOGICAL_OR: _emitter.or$ ();  break;
-    default:          /* do nothing */  break;
-    }
-    _symbols.pop_storage (1);
+/* --- end a bracketed expression, leaving its value as an operand of the
+   one around it (unless it was the outermost, when false is returned) */
+bool parser::close () {
+  context c = _contexts.back ();
+  _contexts.pop_back ();
+  _operators.pop_back ();       /* -- the OPENING */
+  if (END_OF_FILE == c.closer) {
+    return false;
   }
-  PREMATURE_END_NONTERMINAL_HANDLER;
-  return t1;
-} END_NONTERMINAL_HANDLER;
+  token_set const & stop = _contexts.back ().factor;
+  if (RIGHT_PAREN == c.closer) {
+    expect (RIGHT_PAREN, stop);
+  } else {
+    ast::expression *index = _operands.back ().node;
+    _operands.pop_back ();
+    if (type::integer != index->type && type::universal != index->type) {
+      error (error::input::integer);
+    }   
+    expect (RIGHT_BRACKET, stop);
+    push (variable (c.name, c.array, index, c.line, c.selector));
+  }
+  return true;
+}
 
 /* --------------------------------------------------------------------*/
 
-/* PrimaryExpression = SimpleExpression [ RelationalOperator	\
-   SimpleExpression ] . */
-/* RelationalOperator = "<" | "=" | ">" . */
-BEGIN_NONTERMINAL_HANDLER (type::code, primary_expression)  {
-  type::code t1, t2; token_code code;
-  bool relational = false;
-  t1 = simple_expression (FIRST (RELATIONAL_OPERATOR) 
-			   + FIRST (SIMPLE_EXPRESSION) + stop);
-  /* RelationalOperator (= "<" | "=" | ">" .) */
-  syntax_check (FIRST (RELATIONAL_OPERATOR) 
-		 + FIRST (SIMPLE_EXPRESSION) + stop);
-  while (_token >= EQUAL && _token <= LESS_THAN) {
-    code = _token;
-    relational = true;    
-    expect (_token, FIRST (SIMPLE_EXPRESSION) + stop);
-    t2 = simple_expression (FIRST (RELATIONAL_OPERATOR) 
-			     + FIRST (SIMPLE_EXPRESSION) + stop);    
-    type_check (t1, t2);
-    switch (code) {
-    case GREATER_THAN: _emitter.greater (); break;
-    case        EQUAL: _emitter.equal ();   break;    
-    case    LESS_THAN: _emitter.less ();    break;
-    default:           /* do nothing */     break;
-    } 
-    _symbols.pop_storage (1);
-  }  
-  PREMATURE_END_NONTERMINAL_HANDLER;
-  /* -- here we determine if we have done a comparison of if we've 
-     simply wrapped a simple expression.  if we've done a comparison
-     then we change the type to boolean; otherwise, keep the wrapped 
-     type */
-  return relational ? type::boolean : t1;
-} END_NONTERMINAL_HANDLER;
+void parser::push (int precedence) {
+  pending p = { _token, precedence };
+  _operators.push_back (p);
+}
 
 /* --------------------------------------------------------------------*/
 
-/* SimpleExpression = [ "-" ] Term { AddingOperator Term } . */
-BEGIN_NONTERMINAL_HANDLER (type::code, simple_expression)  {  
-  type::code t1, t2; token_code code;
-  /* [ "-" ] Term */
-  bool negative = false; 
-  syntax_check (SYMBOLS (MINUS) + stop);
-  if (MINUS == _token) { 
-    negative = true;
-    expect (MINUS, FIRST (ADDING_OPERATOR) + FIRST (TERM) + stop);
-  }
-  t1 = term (FIRST (ADDING_OPERATOR) + FIRST (TERM) + stop);
-  if (negative) { 
-    type_check (t1, type::integer); 
-    _emitter.minus ();
-  }
-  /* { AddingOperator (= "+" | "-" .) Term } */
-  syntax_check (FIRST (ADDING_OPERATOR) + FIRST (TERM) + stop);
-  while (PLUS == _token || MINUS == _token) {
-    code = _token;
-    expect (_token, FIRST (TERM) + stop);
-    t2 = term (FIRST (ADDING_OPERATOR) + FIRST (TERM) + stop);    
-    type_check (t1, t2); 
-    switch (code) {
-    case  PLUS: _emitter.add ();      break;
-    case MINUS: _emitter.subtract (); break;
-    default:    /* do nothing */      break;
-    }
-    _symbols.pop_storage (1);
-  }  
-  PREMATURE_END_NONTERMINAL_HANDLER;
-  return t1;
-} END_NONTERMINAL_HANDLER;
+void parser::push (ast::expression *e) {
+  operand o = { e, e->type };
+  _operands.push_back (o);
+}
 
 /* --------------------------------------------------------------------*/
 
-/* Term = Factor { MultiplyingOperator Factor } . */
-BEGIN_NONTERMINAL_HANDLER (type::code, term)  {
-  type::code t1, t2; token_code code;
-  t1 = factor (FIRST (MULTIPLYING_OPERATOR) + FIRST (FACTOR) + stop);
-  /* MultiplyingOperator (= "*" | "/" | "\" .) Factor */
-  while (_token >= MULTIPLY && _token <= MODULO) {
-    code = _token;
-    expect (_token, FIRST (FACTOR) + stop);
-    syntax_check (FIRST (MULTIPLYING_OPERATOR) + FIRST (FACTOR) + stop);
-    t2 = factor (FIRST (MULTIPLYING_OPERATOR) + FIRST (FACTOR) + stop);
-    type_check (t1, t2);    
-    switch (code) {
-    case MULTIPLY: _emitter.multiply (); break;
-    case   DIVIDE: _emitter.divide ();   break;
-    case   MODULO: _emitter.modulo ();   break;
-    default:       /* do nothing */      break;
-    }
-    _symbols.pop_storage (1);
-  }
-  PREMATURE_END_NONTERMINAL_HANDLER;
-  return t1;
-} END_NONTERMINAL_HANDLER;
+/* --- apply the operator on top of the stack to the two operands on top
+   of the stack: their types must agree, and the result has the left's 
+   type (a comparison's is Boolean, but a chain of them goes on checking 
+   against the first operand's type) */
+void parser::reduce () {
+  pending  p = _operators.back ();
+  operand  r = _operands.back ();
+  _operators.pop_back ();
+  _operands.pop_back ();
+  operand &l = _operands.back ();
+  type_check (l.type, r.type);
+  l.node = _nodes.make<ast::binary> (_token.offset (), p.op, 
+				     RELATIONAL == p.precedence 
+				     ? type::boolean : l.type, l.node, r.node);
+}
 
 /* --------------------------------------------------------------------*/
 
-/* Factor = Constant | VariableAccess | "(" Expression ")" | "~" Factor . */
-BEGIN_NONTERMINAL_HANDLER (type::code, factor)  {
-  string name; constant_type c; token tok;
-  type::code type = type::universal;
-  // bool is_constant = false;
-  switch (_token) {    
-  case LEFT_PAREN:
-    /* "(" Expression ")" */
-    expect (LEFT_PAREN, FIRST (EXPRESSION) 
-	     + SYMBOLS (RIGHT_PAREN) + stop);
-    type = expression (SYMBOLS (RIGHT_PAREN) + stop);
-    expect (RIGHT_PAREN, stop);
-    break;
-  case LOGICAL_NOT:
-    /* "~" Factor */
-    expect (LOGICAL_NOT, FIRST (FACTOR) + stop);
-    type = factor (stop);
-    type_check (type, type::boolean);
-    _emitter.not$ ();
-    break;
-  default:
-    /* Constant | VariableAccess (= VariableName [ IndexedSelector ] .) */
-    /* NOTE: this is ambiguous, as a constant can be a variable name too.
-       To solve this we take note of the starting token, if it is an 
-       identifier, then we will test for indexed selector after we parse
-       the next token, then parse the index accessor, if nessesary.
-
-       This works because constant() is equivalent to variable_access() in
-       that it matches IDENTIFIERs, but not indexed_selector(); hence, we
-       simulate the remainder of variable_access() here.
-       
-       void variable_access () {
-         match (IDENTIFIER);
-         if (LEFT_BRACKET == _token) {
-           indexed_selector (stop);
-         }  
-       }
-    */
-        
-    if (IDENTIFIER == _token) {
-      _token.value (name);
-      tok = find (name);
-      if (tok.kind () == kind::constant) { 
-	c = constant (stop);      
-	_emitter.constant (c.first);
-	_symbols.push_storage (1);
-	type = c.second;      
-      } else {
-	tok = variable_access (stop);
-	_emitter.value ();
-	_symbols.push_storage (1);
-	type = tok.type ();
-      }
-    } else {
-      c = constant (stop);      
-      _emitter.constant (c.first);
-      _symbols.push_storage (1);
-      type = c.second;      
-    }
-    
-    /*
-    if (IDENTIFIER == _token) {
-      _token.value (name);
-      tok = find (name);
-      if (tok.kind () == kind::constant) { 
-	is_constant = true;
-      } else {
-	tok = variable_access (stop);
-	_emitter.value ();
-	_symbols.push_storage (1);
-	type = tok.type ();   
-      } 
-    }      
-    if (is_constant) {
-      c = constant (stop);      
-      _emitter.constant (c.first);
-      _symbols.push_storage (1);
-      type = c.second;      
-    }
-    */
-    break;    
-  }
-  PREMATURE_END_NONTERMINAL_HANDLER;
-  return type;
-} END_NONTERMINAL_HANDLER;
+/* --- apply a "-" or a "~" to the operand on top of the stack, which
+   must be of the given type */
+void parser::reduce_unary (type::code type) {
+  pending  p = _operators.back ();
+  operand &o = _operands.back ();
+  _operators.pop_back ();
+  type_check (o.type, type);
+  o.node = _nodes.make<ast::unary> (_token.offset (), p.op, o.type, o.node);
+}
 
 /* --------------------------------------------------------------------*/
 
+/* --- a variable, or an element of an array variable */
+ast::identifier* parser::variable (token const & name, symboltbl::handle h,
+				   ast::expression *index, int line, 
+				   unsigned selector) {
+  symbol const & s = _symbols[h];
+  int level = _symbols.level () - s.level;
+  if (index) {
+    return _nodes.make<ast::access> (_token.offset (), name, s.type, level,
+				     s.displacement, index, s.size, line, 
+				     selector);
+  }
+  return _nodes.make<ast::identifier> (_token.offset (), name, s.type, 
+				       level, s.displacement);
+}
+
+/* --------------------------------------------------------------------*/
 /* IndexedSelector = "[" Expression "]" . */
-BEGIN_NONTERMINAL_HANDLER_X (void, indexed_selector (int upper, token_set
-						       const &stop))  {
-  int line = _scanner.line ();  
+BEGIN_NONTERMINAL_HANDLER (ast::expression*, indexed_selector)  {
   expect (LEFT_BRACKET, FIRST (EXPRESSION) 
 	   + SYMBOLS (RIGHT_BRACKET) + stop);  
-  type::code type = expression (SYMBOLS (RIGHT_BRACKET) + stop);
-  if (type::integer != type && type::universal != type) {
+  ast::expression *index = expression (SYMBOLS (RIGHT_BRACKET) + stop);
+  if (type::integer != index->type && type::universal != index->type) {
     error (error::input::integer);
   }   
-  _emitter.index (upper, line);
   expect (RIGHT_BRACKET, stop);
+  PREMATURE_END_NONTERMINAL_HANDLER;
+  return index;
 } END_NONTERMINAL_HANDLER;
 
 /* --------------------------------------------------------------------*/
-
 /* Constant = Numeral | BooleanSymbol | ConstantName . */
 /* Numeral = Digit { Digit } . */
 /* BooleanSymbol = "false" | "true" . */
 /* Name = Letter { Letter | Digit | "_" } . */
 BEGIN_NONTERMINAL_HANDLER (parser::constant_type, constant)  {
-  string name; token t; int x = -1;
+  atom::id name; symboltbl::handle h; int x = -1;
   type::code type = type::universal;    
   switch (_token) {
   case IDENTIFIER:
     /* -- here the type of the constant will be inffered from the 
        identifier we are given */    
-    _token.value ( name );
-    t = find ( name );
-    if ( t.kind () != kind::constant ) {
-      type = t.type ();
-      t.value (x);
+    name = _token.spelling ();
+    h = find ( name );
+    if ( _symbols[h].kind != kind::constant ) {
+      type = _symbols[h].type;
+      x    = _symbols[h].value;
     } else {
-      error (error::input::constant, t);
+      error (error::input::constant, name);
     }    
     break;
   case TRUE:
@@ -1091,7 +1113,7 @@ BEGIN_NONTERMINAL_HANDLER (parser::constant_type, constant)  {
     break;
   case NUMBER:
     type = type::integer;
-    _token.value (x);    
+    x = _token.value ();
     break;
   default:
     /* ERROR! - can't get here */    
@@ -1105,20 +1127,71 @@ BEGIN_NONTERMINAL_HANDLER (parser::constant_type, constant)  {
 
 /* --------------------------------------------------------------------*/
 
-void parser::parse () {  
+/* --- the whole program's syntax tree, in the arena */
+ast::program* parser::parse () {  
+  if (_pretokenize) {           /* -- tokenize the whole source first */
+    if (_tokens.empty ()) {     /* (once: parsing again reuses it) */
+      _scanner.scan_all (_tokens, _lex_threads);
+    }
+    _next = 0;
+  } else {
+    _scanner.start ();          /* start at the top of the source, */
+  }
   move ();                      /* boot-strap the parser and get the */
-  program (SYMBOLS (END_OF_FILE)); /* first token, then match the 
-					  main block */
+  ast::program *p = program (SYMBOLS (END_OF_FILE)); /* first token, 
+							then match the 
+							main block */
+  TRACE_REPORT;
+  return p;
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- how many statements have been parsed, over every parse */
+unsigned long parser::statements () const {
+  return _statements;
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- where the current token is, as an offset in to the source, and
+   as a line and column (which take a search to find) */
+unsigned int parser::offset () const {
+  return _token.offset ();
 }
 
 /* --------------------------------------------------------------------*/
 
 unsigned int parser::line () const {
-  return _scanner.line ();
+  return _scanner.line (_token.offset ());
 }
 
 /* --------------------------------------------------------------------*/
 
 unsigned int parser::column () const {
-  return _scanner.column ();
+  return _scanner.column (_token.offset ());
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- whether to tokenize the whole source before parsing it (rather
+   than a token at a time, as the parser asks for them) */
+void parser::pretokenize (bool on) {
+  _pretokenize = on;
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- how many threads to tokenize a large source on, when it is
+   tokenized up front */
+void parser::lex_threads (unsigned int n) {
+  _lex_threads = n;
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- scan with the original, hand-written scanner, rather than the
+   automaton (for comparing the two) */
+void parser::legacy_scanner (bool on) {
+  _scanner.legacy (on);
 }
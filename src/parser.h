@@ -8,14 +8,14 @@
 #ifndef PARSER_H
 #define PARSER_H
 
+#include "arena.h"
+#include "ast.h"
 #include "error.h"
-#include "emitter.h"
 #include "scanner.h"
 #include "setops.h"
 #include "symboltbl.h"
 #include "token.h"
 #include <exception>
-#include <fstream>
 #include <vector>
 
 /*----------------------------------------------------------------------
@@ -38,30 +38,37 @@ class parser {
 
 private:
 
-  emitter_interface &_emitter;    /* error manager */
+  arena             &_nodes;      /* where the syntax tree is built */
   error_interface   &_errors;     /* error manager */
   scanner            _scanner;    /* stream scanner (lexer) */
   symboltbl         &_symbols;    /* main symbol table */  
   token              _token;      /* current token */
-  token              _null;       /* null token -- for errors n' stuff */
+  token_buffer       _tokens;     /* every token, when pre-tokenized */
+  size_t             _next;       /* the next of _tokens to move to */
+  bool               _pretokenize; /* lex the whole source up front? */
+  unsigned int       _lex_threads; /* threads to do that on */
   token_code         _expected;   /* last expected token */
-  token_set          _first_symbols[LAST_TOKEN]; /* BNF derived first symbols */
+  unsigned long      _statements; /* parsed so far */
+  std::vector<atom::id> _names;   /* a variable definition's names */
   static int         _next_label; /* counter to ensure unique labels */  
 
   token_code move ();
   int new_label (); 
   
   void expect (token_code, token_set const&);
-  void expect (std::string&, token_set const&);
-  token& define (std::string const&, kind::code, type::code = type::universal,
-		  int = 0, int = 0, int = 0, int = 0);
-  token& find (std::string const&);
+  void expect (atom::id&, token_set const&);
+  symboltbl::handle define (atom::id, kind::code, 
+			     type::code = type::universal,
+			     int = 0, int = 0, int = 0, int = 0);
+  symboltbl::handle find (atom::id);
 
-  void suggest(std::string const&);
+  void suggest (atom::id);
     
   void error (error::input::code) const;
   void error (error::input::code, token const&) const;
-  void error (error::input::code, token const&, token const&) const;
+  void error (error::input::code, atom::id) const;
+  void error (error::input::code, char const*) const;
+  void error (error::input::code, char const*, token const&) const;
   
   void syntax_check (token_set const&);
   void syntax_error (token_set const&);
@@ -69,40 +76,94 @@ private:
   void type_check (type::code&, type::code);
 
   typedef std::pair<int, type::code> constant_type;
-  typedef std::vector<type::code>    expression_vector;
-  typedef std::vector<token>         token_vector;  
+
+  /* --- the expression parser's stacks: bracketed expressions (with 
+     the stop sets of their levels), operators waiting for their right
+     operand, and operands (with their types as a chain of comparisons
+     sees them) */
+  struct context {
+    token_code        closer;   /* ")", "]", or END_OF_FILE outermost */
+    token_set         any, primary, simple, term, factor;
+    token             name;     /* -- an index's array, */
+    symboltbl::handle array;
+    int               line;     /* and its "[" */
+    unsigned int      selector;
+  };
+  struct pending {
+    token             op;
+    int               precedence;
+  };
+  struct operand {
+    ast::expression  *node;
+    type::code        type;
+  };
+  std::vector<context> _contexts;
+  std::vector<pending> _operators;
+  std::vector<operand> _operands;
+
+  /* --- the statement parser's stack: an if or do statement whose
+     guarded commands are being parsed, with the statement part it is
+     in, and the guarded command whose statements are being parsed */
+  struct nesting {
+    token_code                      kind;     /* IF or DO */
+    token_set                       stop;     /* -- the statement part's */
+    ast::list<ast::statement>       statements; /* (so far) */
+    ast::list<ast::guarded_command> commands;
+    token_set                       commands_stop;
+    int                             label,    /* the next guard's */
+                                    end;      /* after an if, atop a do */
+    ast::expression                *guard;    /* -- the command's */
+    int                             entry;
+    unsigned int                    offset, arrow;
+  };
+  std::vector<nesting> _nestings;
+
+  void nest (token_code, ast::list<ast::statement>&, token_set&);
+  void guarded_command (token_set const&, ast::list<ast::statement>&, 
+			token_set&);
+  void end_statement (ast::statement*, ast::list<ast::statement>&, 
+		      token_set const&);
+
+  void open (token_code, token_set const&, token const& = token (),
+	     symboltbl::handle = symboltbl::none);
+  bool close ();
+  void push (int);
+  void push (ast::expression*);
+  void reduce ();
+  void reduce_unary (type::code);
+  ast::identifier* variable (token const&, symboltbl::handle, 
+			     ast::expression* = NULL, int = 0, 
+			     unsigned int = 0);
       
-  /* --- a method for each (useful) non-terminal in the PL grammar */
-  NONTERMINAL_HANDLER (void, program);
-  NONTERMINAL_HANDLER_X (void, block (int, int, token_set const&));
-  NONTERMINAL_HANDLER_X (int, definition_part (int&, token_set const&));
+  /* --- a method for each (useful) non-terminal in the PL grammar,
+     returning the nodes of the syntax tree it builds */
+  NONTERMINAL_HANDLER (ast::program*, program);
+  NONTERMINAL_HANDLER_X (ast::block*, block (int, int, token_set const&));
+  NONTERMINAL_HANDLER_X (int, definition_part (int&, 
+						 ast::list<ast::procedure>&,
+						 token_set const&));
   NONTERMINAL_HANDLER (void, constant_definition);
   NONTERMINAL_HANDLER_X (int, variable_definition (int&, 
 						     token_set const&));  
-  NONTERMINAL_HANDLER (void, procedure_definition);
-  NONTERMINAL_HANDLER (void, statement_part);
-  NONTERMINAL_HANDLER (token_vector, variable_access_list);
-  NONTERMINAL_HANDLER (expression_vector, expression_list);
-  NONTERMINAL_HANDLER_X (void, guarded_command_list (int&, int, 
-						       token_set const&));
-  NONTERMINAL_HANDLER_X (void, guarded_command (int&, int, 
-						token_set const&));
-  NONTERMINAL_HANDLER (type::code, expression);
-  NONTERMINAL_HANDLER (type::code, primary_expression);
-  NONTERMINAL_HANDLER (type::code, simple_expression);
-  NONTERMINAL_HANDLER (type::code, term);
-  NONTERMINAL_HANDLER (void, multiplying_operator);
-  NONTERMINAL_HANDLER (type::code, factor);
-  NONTERMINAL_HANDLER (token, variable_access);
-  NONTERMINAL_HANDLER_X (void, indexed_selector (int, token_set const&));
+  NONTERMINAL_HANDLER (ast::procedure*, procedure_definition);
+  NONTERMINAL_HANDLER (ast::list<ast::statement>, statement_part);
+  NONTERMINAL_HANDLER (ast::list<ast::expression>, variable_access_list);
+  NONTERMINAL_HANDLER (ast::list<ast::expression>, expression_list);
+  NONTERMINAL_HANDLER (ast::expression*, expression);
+  NONTERMINAL_HANDLER (ast::identifier*, variable_access);
+  NONTERMINAL_HANDLER (ast::expression*, indexed_selector);
   NONTERMINAL_HANDLER (constant_type, constant);
 
 public:
 
-  parser (std::ifstream&, symboltbl&, error_interface&, 
-	   emitter_interface&);  
-  void parse ();
+  parser (source const&, symboltbl&, arena&, error_interface&);  
+  ast::program* parse ();
+  unsigned long statements () const;
+  void pretokenize (bool);
+  void lex_threads (unsigned int);
+  void legacy_scanner (bool);
 
+  unsigned int offset () const;
   unsigned int line () const;
   unsigned int column () const;
 
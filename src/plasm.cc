@@ -0,0 +1,165 @@
+/*----------------------------------------------------------------------
+  File    : plasm.cc
+  Contents: stand-alone PL machine assembler
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "assembler.h"
+#include "ir.h"
+#include "source.h"
+#include <charconv>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+/*----------------------------------------------------------------------
+  Namespace Inclusions
+----------------------------------------------------------------------*/
+
+using std::cerr;
+using std::cout;
+using std::from_chars;
+using std::ofstream;
+using std::ostream;
+using std::string;
+
+/*----------------------------------------------------------------------
+  Helper Functions
+----------------------------------------------------------------------*/
+
+static void usage () {
+  cout << "usage: plasm [options] [infile [outfile]]" << '\n';
+  cout << "-v         verbose output (assembly rate)" << '\n';
+  cout << "infile     file to read PL machine assembly from (default stdin)"
+       << '\n';
+  cout << "outfile    file to write VM code to (default stdout)" << '\n';
+}
+
+/* --------------------------------------------------------------------*/
+
+static int fail (char const *fn, int line, char const *msg,
+		 string const & what) {
+  cerr << "plasm: " << fn << ":" << line << ": " << msg << " `" << what
+       << "'\n";
+  return EXIT_FAILURE;
+}
+
+/* --------------------------------------------------------------------*/
+
+static inline bool space (char c) {
+  return ' ' == c || ('\t' <= c && c <= '\r');
+}
+
+/*----------------------------------------------------------------------
+  Main Functions
+----------------------------------------------------------------------*/
+
+int main (int argc, char *argv[]) { /* --- main function */
+  char const *fn_in = NULL, *fn_out = NULL;
+  bool        verbose = false;
+  int         k = 0;
+
+  /* --- evaluate arguments --- */
+  for (int i = 1; i < argc; ++i) {
+    char *s = argv[i];
+    if ('-' == *s && s[1]) {
+      while (*++s) {
+	switch (*s) {
+	case 'v': verbose = true; break;
+	default:
+	  cerr << "plasm: unknown option -" << *s << '\n';
+	  usage ();
+	  return EXIT_FAILURE;
+	}
+      }
+    } else {
+      switch (k++) {
+      case 0: fn_in  = s; break;
+      case 1: fn_out = s; break;
+      default:
+	cerr << "plasm: wrong number of arguments\n";
+	usage ();
+	return EXIT_FAILURE;
+      }
+    }
+  }
+
+  source src;
+  if (!src.open (fn_in)) {
+    cerr << "plasm: cannot open file " << fn_in << '\n';
+    return EXIT_FAILURE;
+  }
+  char const *fn = fn_in ? fn_in : "<stdin>";
+
+  ofstream fout;
+  if (fn_out) {
+    fout.open (fn_out, ofstream::out | ofstream::binary);
+    if (!fout.good ()) {
+      cerr << "plasm: cannot open file " << fn_out << '\n';
+      return EXIT_FAILURE;
+    }
+  }
+  ostream & out = fn_out ? static_cast<ostream&> (fout) : cout;
+
+  /* --- assemble, an instruction at a time, straight from the source
+     text: a mnemonic followed by its integer operands --- */
+  clock_t     start = clock ();
+  char const *p = src.begin (), *end = src.end (), *word;
+  int         line = 1;
+  int        *operand[2];
+  Assembler   assembler (out);
+  ir::instruction next;
+  for (;;) {
+    while (p < end && space (*p)) {
+      line += '\n' == *p++;
+    }
+    if (p == end) {
+      break;
+    }
+    for (word = p; p < end && !space (*p); ++p) {
+    }
+    next.op = ir::operation (word, p - word);
+    next.x = next.y = 0;
+    if (-1 == next.op) {
+      return fail (fn, line, "unknown operator", string (word, p - word));
+    }
+    operand[0] = &next.x;
+    operand[1] = &next.y;
+    for (int i = 0, n = ir::operands (next.op); i < n; ++i) {
+      while (p < end && space (*p)) {
+	line += '\n' == *p++;
+      }
+      std::from_chars_result r = from_chars (p, end, *operand[i]);
+      if (r.ec != std::errc () || (r.ptr < end && !space (*r.ptr))) {
+	for (word = p; p < end && !space (*p); ++p) {
+	}
+	return fail (fn, line, "integer expected, not",
+		     string (word, p - word));
+      }
+      p = r.ptr;
+    }
+    assembler.instruction (next);
+    if (opcode::end_program == next.op) {
+      break;
+    }
+  }
+  assembler.finish ();
+  size_t words = assembler.size ();
+
+  if (verbose) {
+    double t = static_cast<double> (clock () - start) / CLOCKS_PER_SEC;
+    cerr << fn << ": " << words << " words in " << t << "s";
+    if (t > 0) {
+      cerr << " (" << static_cast<long> (words / t) << " words/s)";
+    }
+    cerr << '\n';
+  }
+  return out.good () ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -57,8 +57,25 @@ int main (int argc, char *argv[]) { /* --- main function */
 	 << PACKAGE_BUGREPORT << ")" << '\n';    
   } else {                      /* if no arguments given */
     cout << "usage: " << PACKAGE << " [options] infile [outfile]" << '\n';
+    cout << "-r, --run  run the program instead of writing VM code" << '\n';
+    cout << "-e engine  run with the given engine: switch, threaded or jit" 
+	 << '\n';
+    cout << "-t target  write the given target: vm (default), asm, image, c, exe"
+	 << " or gas"
+	 << '\n';
+    cout << "-p         tokenize the whole source before parsing"
+	 << " (--pretokenize)" << '\n';
+    cout << "-l         scan with the original, hand-written scanner"
+	 << " (--legacy-scanner)" << '\n';
+    cout << "-j threads tokenize a large source on this many threads, or on"
+	 << " every core" << '\n'
+	 << "           for 0 (--jobs); implies -p" << '\n';
+    cout << "-v         verbose output (run times, and the parser's heap use"
+	 << '\n'
+	 << "           with --enable-heap-count)" << '\n';
     cout << "infile     file to read PL code" << '\n';
-    cout << "outfile    file to write VM code to" << '\n';
+    cout << "outfile    file to write the target (or program output) to" 
+	 << '\n';
     return 0;                   /* print a usage message */
   }                             /* and abort the program */
 
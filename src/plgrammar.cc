@@ -0,0 +1,672 @@
+/*----------------------------------------------------------------------
+  File    : plgrammar.cc
+  Contents: derives the parser's first sets from the grammar
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "token.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <set>
+#include <string>
+#include <vector>
+
+/*----------------------------------------------------------------------
+  Namespace Inclusions
+----------------------------------------------------------------------*/
+
+using std::cerr;
+using std::cout;
+using std::ifstream;
+using std::istreambuf_iterator;
+using std::ostream;
+using std::set;
+using std::string;
+using std::vector;
+
+/*----------------------------------------------------------------------
+  Grammar - the rules as doc/pl-grammar.txt writes them, in Wirth's
+  EBNF: "=" defines a rule, which ends with a ".", "|" separates
+  alternatives, [ ] is an option and { } a repetition.  Quoted words
+  are the scanner's tokens, by their friendly names (see token.cc);
+  lines starting "//" are comments, and a "\" continues a line.
+----------------------------------------------------------------------*/
+
+/* --- one piece of a rule's right-hand side */
+struct term {
+  enum code { symbol, terminal, sequence, choice, option, repetition };
+  code         kind;
+  string       name;            /* of a symbol, as written */
+  int          id;              /* of the rule, or the terminal */
+  int          line;
+  vector<term> parts;
+};
+
+/* --- a terminal: the token it is, and what it stands for.  The scanner
+   calls ConstantName, VariableName and ProcedureName all identifiers,
+   but the parser tells them apart by what the name is defined as, so
+   they count as different terminals when looking for conflicts */
+struct terminal {
+  token_code code;
+  string     name;
+};
+
+struct rule {
+  string   name;
+  term     body;
+  int      line;
+  int      lexical;             /* its terminal, if the scanner reads it */
+  bool     nullable;
+  set<int> first, follow;       /* terminals */
+};
+
+/* --- rules that the scanner reads, as a single token */
+static struct {
+  char const *name;
+  token_code  code;
+} const lexical_rules[] = {
+  { "Numeral", NUMBER },
+  { "Name",    IDENTIFIER }
+};
+
+/* --------------------------------------------------------------------*/
+
+static char const       *file;
+static vector<rule>      rules;
+static vector<terminal>  terminals;
+static int               errors = 0;
+
+/*----------------------------------------------------------------------
+  Helper Functions
+----------------------------------------------------------------------*/
+
+static void usage () {
+  cout << "usage: plgrammar [-t] grammar" << '\n';
+  cout << "grammar    the grammar, in EBNF (doc/pl-grammar.txt)" << '\n';
+  cout << "-t         list each rule's first and follow sets and which "
+       << '\n'
+       << "           tokens predict it, instead of writing the first sets"
+       << '\n'
+       << "           out as a C++ header" << '\n';
+}
+
+/* --------------------------------------------------------------------*/
+
+static void error (int line, string const & message) {
+  cerr << "plgrammar: " << file << ":" << line << ": " << message << '\n';
+  ++errors;
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- the terminal for a token, added on first use */
+static int intern (token_code c, string const & name) {
+  for (size_t i = 0; i < terminals.size (); ++i) {
+    if (terminals[i].code == c && terminals[i].name == name) {
+      return i;
+    }
+  }
+  terminal t = { c, name };
+  terminals.push_back (t);
+  return terminals.size () - 1;
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- a rule's name as an enumerator: VariableDefinition1 becomes
+   VARIABLE_DEFINITION1 */
+static string enumerator (string const & name) {
+  string s;
+  for (size_t i = 0; i < name.size (); ++i) {
+    if (i > 0 && isupper (name[i]) && !isupper (name[i - 1])) {
+      s += '_';
+    }
+    s += toupper (name[i]);
+  }
+  return s;
+}
+
+/*----------------------------------------------------------------------
+  Reading the Grammar
+----------------------------------------------------------------------*/
+
+class reader {
+
+private:
+
+  string      _text;
+  size_t      _at;
+  int         _line;
+  string      _word;            /* the current token's text */
+  char        _kind;            /* 'w'ord, '"' literal, punctuation, 0 */
+
+  void next ();
+  term expression ();
+  term sequence ();
+  void expect (char);
+
+public:
+
+  explicit reader (string const & text)
+    : _text (text), _at (0), _line (1) { next (); }
+
+  bool read ();
+
+};
+
+/* --------------------------------------------------------------------*/
+
+/* --- on to the next token, past spaces, comments and continuations */
+void reader::next () {
+  for (;;) {
+    while (_at < _text.size () && isspace (_text[_at])) {
+      _line += '\n' == _text[_at++];
+    }
+    if (0 == _text.compare (_at, 2, "//")) {
+      _at = _text.find ('\n', _at);
+    } else if (0 == _text.compare (_at, 1, "\\")) {
+      ++_at;
+    } else {
+      break;
+    }
+  }
+  _word.clear ();
+  if (_at >= _text.size ()) {
+    _kind = 0;
+  } else if (isalpha (_text[_at])) {
+    _kind = 'w';
+    while (_at < _text.size ()
+	   && (isalnum (_text[_at]) || '_' == _text[_at])) {
+      _word += _text[_at++];
+    }
+  } else if ('"' == _text[_at]) {
+    _kind = '"';
+    size_t end = _text.find ('"', _at + 1);
+    if (string::npos == end) {
+      error (_line, "unterminated literal");
+      end = _text.size ();
+    }
+    _word = _text.substr (_at + 1, end - _at - 1);
+    _at = end + 1;
+  } else {
+    _kind = _text[_at++];
+  }
+}
+
+/* --------------------------------------------------------------------*/
+
+void reader::expect (char c) {
+  if (c != _kind) {
+    error (_line, string ("\"") + c + "\" expected");
+  }
+  next ();
+}
+
+/* --------------------------------------------------------------------*/
+
+/* Grammar = { Name "=" Expression "." } . */
+bool reader::read () {
+  while ('w' == _kind) {
+    rule r;
+    r.name     = _word;
+    r.line     = _line;
+    r.lexical  = -1;
+    r.nullable = false;
+    next ();
+    expect ('=');
+    r.body = expression ();
+    expect ('.');
+    rules.push_back (r);
+  }
+  if (0 != _kind) {
+    error (_line, "rule expected");
+  }
+  return 0 == errors;
+}
+
+/* --------------------------------------------------------------------*/
+
+/* Expression = Sequence { "|" Sequence } . */
+term reader::expression () {
+  term t = sequence ();
+  if ('|' != _kind) {
+    return t;
+  }
+  term c = { term::choice, "", 0, t.line, vector<term> (1, t) };
+  while ('|' == _kind) {
+    next ();
+    c.parts.push_back (sequence ());
+  }
+  return c;
+}
+
+/* --------------------------------------------------------------------*/
+
+/* Sequence = { Name | Literal | "(" Expression ")"
+              | "[" Expression "]" | "{" Expression "}" } . */
+term reader::sequence () {
+  term s = { term::sequence, "", 0, _line, vector<term> () };
+  for (;;) {
+    term t = { term::symbol, _word, 0, _line, vector<term> () };
+    if ('w' == _kind) {
+      next ();
+    } else if ('"' == _kind) {
+      t.kind = term::terminal;
+      t.id   = -1;
+      for (int c = UNKNOWN + 1; c < LAST_TOKEN; ++c) {
+	if (_word == token::friendly_name (static_cast<token_code> (c))) {
+	  t.id = intern (static_cast<token_code> (c), "\"" + _word + "\"");
+	}
+      }
+      next ();
+    } else if ('(' == _kind || '[' == _kind || '{' == _kind) {
+      char closer = '(' == _kind ? ')' : '[' == _kind ? ']' : '}';
+      t.kind = ')' == closer ? term::sequence
+	: ']' == closer ? term::option : term::repetition;
+      next ();
+      t.parts.push_back (expression ());
+      expect (closer);
+    } else {
+      break;
+    }
+    s.parts.push_back (t);
+  }
+  return 1 == s.parts.size () ? s.parts[0] : s;
+}
+
+/*----------------------------------------------------------------------
+  Analysis
+----------------------------------------------------------------------*/
+
+/* --- point each symbol at its rule, or at the terminal it stands for
+   (only the parser's rules are resolved: the scanner's are written in
+   characters, not tokens) */
+static void resolve (term & t) {
+  for (size_t i = 0; i < t.parts.size (); ++i) {
+    resolve (t.parts[i]);
+  }
+  if (term::terminal == t.kind && -1 == t.id) {
+    error (t.line, "the scanner has no token \"" + t.name + "\"");
+  }
+  if (term::symbol != t.kind) {
+    return;
+  }
+  for (size_t i = 0; i < rules.size (); ++i) {
+    if (rules[i].name == t.name) {
+      if (-1 != rules[i].lexical) {
+	t.kind = term::terminal;
+	t.id   = rules[i].lexical;
+      } else {
+	t.id = i;
+      }
+      return;
+    }
+  }
+  /* --- the names of things are all identifiers to the scanner */
+  size_t n = t.name.size ();
+  if (n > 4 && 0 == t.name.compare (n - 4, 4, "Name")) {
+    t.kind = term::terminal;
+    t.id   = intern (IDENTIFIER, t.name);
+    return;
+  }
+  error (t.line, t.name + " is not defined");
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- add the terminals a term can start with to s, and say whether it
+   can also be empty */
+static bool first (term const & t, set<int> & s) {
+  bool nullable;
+  switch (t.kind) {
+  case term::terminal:
+    s.insert (t.id);
+    return false;
+  case term::symbol:
+    s.insert (rules[t.id].first.begin (), rules[t.id].first.end ());
+    return rules[t.id].nullable;
+  case term::sequence:
+    for (size_t i = 0; i < t.parts.size (); ++i) {
+      if (!first (t.parts[i], s)) {
+	return false;
+      }
+    }
+    return true;
+  case term::choice:
+    nullable = false;
+    for (size_t i = 0; i < t.parts.size (); ++i) {
+      nullable |= first (t.parts[i], s);
+    }
+    return nullable;
+  default:
+    first (t.parts[0], s);
+    return true;
+  }
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- given what may follow a term, add to the follow sets of the rules
+   it uses; says whether any of them grew */
+static bool follow (term const & t, set<int> const & after) {
+  bool grew = false;
+  set<int> s;
+  switch (t.kind) {
+  case term::terminal:
+    /* --- the scanner's rules follow whatever their tokens do */
+    for (size_t i = 0; i < rules.size (); ++i) {
+      if (-1 != rules[i].lexical
+	  && terminals[rules[i].lexical].code == terminals[t.id].code) {
+	for (set<int>::const_iterator j = after.begin (); j != after.end ();
+	     ++j) {
+	  grew |= rules[i].follow.insert (*j).second;
+	}
+      }
+    }
+    break;
+  case term::symbol:
+    for (set<int>::const_iterator i = after.begin (); i != after.end ();
+	 ++i) {
+      grew |= rules[t.id].follow.insert (*i).second;
+    }
+    break;
+  case term::sequence:
+    s = after;
+    for (size_t i = t.parts.size (); i-- > 0; ) {
+      grew |= follow (t.parts[i], s);
+      set<int> f;
+      if (!first (t.parts[i], f)) {
+	s.clear ();
+      }
+      s.insert (f.begin (), f.end ());
+    }
+    break;
+  case term::choice:
+  case term::option:
+    for (size_t i = 0; i < t.parts.size (); ++i) {
+      grew |= follow (t.parts[i], after);
+    }
+    break;
+  case term::repetition:
+    s = after;
+    first (t.parts[0], s);
+    grew |= follow (t.parts[0], s);
+    break;
+  }
+  return grew;
+}
+
+/* --------------------------------------------------------------------*/
+
+static string names (set<int> const & s) {
+  string r;
+  for (set<int>::const_iterator i = s.begin (); i != s.end (); ++i) {
+    r += (r.empty () ? "" : " ") + terminals[*i].name;
+  }
+  return r;
+}
+
+/* --------------------------------------------------------------------*/
+
+static void clash (int line, string const & where, set<int> const & a,
+		   set<int> const & b) {
+  set<int> both;
+  for (set<int>::const_iterator i = a.begin (); i != a.end (); ++i) {
+    if (b.count (*i)) {
+      both.insert (*i);
+    }
+  }
+  if (!both.empty ()) {
+    error (line, where + " is not LL(1): " + names (both)
+	   + " could start either way");
+  }
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- the grammar is LL(1) when, at each choice (between alternatives,
+   or whether to take an option or go round a repetition again), one
+   token of lookahead is enough to decide */
+static void check (term const & t, string const & in, set<int> const & after) {
+  set<int> s;
+  switch (t.kind) {
+  case term::terminal:
+  case term::symbol:
+    break;
+  case term::sequence:
+    s = after;
+    for (size_t i = t.parts.size (); i-- > 0; ) {
+      check (t.parts[i], in, s);
+      set<int> f;
+      if (!first (t.parts[i], f)) {
+	s.clear ();
+      }
+      s.insert (f.begin (), f.end ());
+    }
+    break;
+  case term::choice:
+    for (size_t i = 0; i < t.parts.size (); ++i) {
+      set<int> a;
+      if (first (t.parts[i], a)) {
+	clash (t.line, in, a, after);
+      }
+      for (size_t j = i + 1; j < t.parts.size (); ++j) {
+	set<int> b;
+	first (t.parts[j], b);
+	clash (t.line, in, a, b);
+      }
+      check (t.parts[i], in, after);
+    }
+    break;
+  case term::option:
+  case term::repetition:
+    first (t.parts[0], s);
+    clash (t.line, in, s, after);
+    if (term::repetition == t.kind) {
+      s.insert (after.begin (), after.end ());
+    } else {
+      s = after;
+    }
+    check (t.parts[0], in, s);
+    break;
+  }
+}
+
+/* --------------------------------------------------------------------*/
+
+static bool analyse () {
+  for (size_t i = 0; i < rules.size (); ++i) {
+    for (size_t j = 0; j < sizeof (lexical_rules) / sizeof (*lexical_rules);
+	 ++j) {
+      if (rules[i].name == lexical_rules[j].name) {
+	rules[i].lexical = intern (lexical_rules[j].code, rules[i].name);
+	rules[i].first.insert (rules[i].lexical);
+      }
+    }
+  }
+  for (size_t i = 0; i < rules.size (); ++i) {
+    if (-1 == rules[i].lexical) {
+      resolve (rules[i].body);
+    }
+  }
+  if (errors || rules.empty ()) {
+    return false;
+  }
+  /* --- first sets, and which rules can be empty, grow until they stop */
+  for (bool grew = true; grew; ) {
+    grew = false;
+    for (size_t i = 0; i < rules.size (); ++i) {
+      if (-1 == rules[i].lexical) {
+	size_t n = rules[i].first.size ();
+	bool nullable = first (rules[i].body, rules[i].first);
+	grew |= n != rules[i].first.size () || nullable != rules[i].nullable;
+	rules[i].nullable = nullable;
+      }
+    }
+  }
+  /* --- and the same for the follow sets, starting from the end of the
+     source after the first rule */
+  rules[0].follow.insert (intern (END_OF_FILE, "EOF"));
+  for (bool grew = true; grew; ) {
+    grew = false;
+    for (size_t i = 0; i < rules.size (); ++i) {
+      if (-1 == rules[i].lexical) {
+	grew |= follow (rules[i].body, rules[i].follow);
+      }
+    }
+  }
+  for (size_t i = 0; i < rules.size (); ++i) {
+    if (-1 == rules[i].lexical) {
+      check (rules[i].body, rules[i].name, rules[i].follow);
+    }
+  }
+  return 0 == errors;
+}
+
+/*----------------------------------------------------------------------
+  Output
+----------------------------------------------------------------------*/
+
+/* --- a set as the parser spells it: make_set (BEGIN, END), members in
+   token order, wrapped to fit beside the comments */
+static void write_set (ostream & out, string const & label, size_t width,
+		       set<int> const & s) {
+  set<int> codes;
+  for (set<int>::const_iterator i = s.begin (); i != s.end (); ++i) {
+    codes.insert (terminals[*i].code);
+  }
+  string line = "  /* " + label + " */";
+  line.resize (width, ' ');
+  line += "make_set (";
+  size_t indent = line.size ();
+  for (set<int>::const_iterator i = codes.begin (); i != codes.end (); ++i) {
+    string member = token::name (static_cast<token_code> (*i));
+    member += std::next (i) == codes.end () ? ")" : ", ";
+    if (line.size () + member.size () > 76) {
+      out << line.substr (0, line.find_last_not_of (' ') + 1) << '\n';
+      line = string (indent, ' ');
+    }
+    line += member;
+  }
+  if (codes.empty ()) {
+    line += ")";
+  }
+  out << line;
+}
+
+/* --------------------------------------------------------------------*/
+
+static void write_header (ostream & out) {
+  char const *base = strrchr (file, '/') ? strrchr (file, '/') + 1 : file;
+  out << "/*--------------------------------------------------------------"
+      << "--------\n"
+      << "  File    : grammar.h\n"
+      << "  Contents: The grammar's first sets, generated by plgrammar\n"
+      << "            from " << base << " (do not edit)\n"
+      << "----------------------------------------------------------------"
+      << "------*/\n\n"
+      << "#ifndef GRAMMAR_H\n"
+      << "#define GRAMMAR_H\n\n"
+      << "#include \"setops.h\"\n"
+      << "#include \"token.h\"\n\n"
+      << "/* --- BNF rule names (for first set indexing) */\n"
+      << "enum bnf_rule {\n";
+  size_t width = 0;
+  for (size_t i = 0; i < rules.size (); ++i) {
+    width = std::max (width, enumerator (rules[i].name).size () + 9);
+  }
+  string line = " ";
+  for (size_t i = 0; i < rules.size (); ++i) {
+    string member = " " + enumerator (rules[i].name) + ",";
+    if (line.size () + member.size () > 76) {
+      out << line << '\n';
+      line = " ";
+    }
+    line += member;
+  }
+  out << line << " LAST_BNF_RULE\n};\n\n";
+  out << "/* --- first sets, one per BNF rule (whether a rule can also be"
+      << "\n   empty is left to the parser) */\n"
+      << "static constexpr token_set first_symbols[LAST_BNF_RULE] = {\n";
+  for (size_t i = 0; i < rules.size (); ++i) {
+    write_set (out, enumerator (rules[i].name), width, rules[i].first);
+    out << (i + 1 < rules.size () ? ",\n" : "\n");
+  }
+  out << "};\n\n#endif\n";
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- the predictive parse table, a rule at a time: which of its
+   alternatives each token it can start with chooses (or just the
+   tokens, when it has only the one), and when it is empty */
+static void write_table (ostream & out) {
+  for (size_t i = 0; i < rules.size (); ++i) {
+    rule const & r = rules[i];
+    out << r.name << (r.nullable ? " (may be empty)" : "") << '\n'
+	<< "  first:  " << names (r.first) << '\n'
+	<< "  follow: " << names (r.follow) << '\n';
+    if (-1 != r.lexical) {
+      out << "  read by the scanner, as "
+	  << token::name (terminals[r.lexical].code) << '\n';
+      continue;
+    }
+    if (term::choice == r.body.kind) {
+      for (size_t j = 0; j < r.body.parts.size (); ++j) {
+	set<int> s;
+	if (first (r.body.parts[j], s)) {
+	  s.insert (r.follow.begin (), r.follow.end ());
+	}
+	out << "  " << j + 1 << ":      " << names (s) << '\n';
+      }
+    } else if (r.nullable) {
+      out << "  empty:  " << names (r.follow) << '\n';
+    }
+  }
+}
+
+/*----------------------------------------------------------------------
+  Main Functions
+----------------------------------------------------------------------*/
+
+int main (int argc, char *argv[]) { /* --- main function */
+  bool table = argc > 1 && 0 == strcmp (argv[1], "-t");
+  if (argc != 2 + table) {
+    usage ();
+    return argc < 2 ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+  file = argv[1 + table];
+  ifstream in (file, ifstream::in | ifstream::binary);
+  if (!in.good ()) {
+    cerr << "plgrammar: cannot open file " << file << '\n';
+    return EXIT_FAILURE;
+  }
+  reader r ((string (istreambuf_iterator<char> (in),
+		     istreambuf_iterator<char> ())));
+  if (!r.read () || !analyse ()) {
+    return EXIT_FAILURE;
+  }
+  if (table) {
+    write_table (cout);
+  } else {
+    write_header (cout);
+  }
+  return cout.flush () ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/*----------------------------------------------------------------------
+  Emacs Configuration
+  Local Variables:
+  mode: C++
+  End:
+----------------------------------------------------------------------*/
@@ -0,0 +1,132 @@
+/*----------------------------------------------------------------------
+  File    : plimage.cc
+  Contents: converts between the text and image forms of a program
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "image.h"
+#include <charconv>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+/*----------------------------------------------------------------------
+  Namespace Inclusions
+----------------------------------------------------------------------*/
+
+using std::cerr;
+using std::cout;
+using std::from_chars;
+using std::ifstream;
+using std::istreambuf_iterator;
+using std::ofstream;
+using std::ostream;
+using std::string;
+using std::vector;
+
+/*----------------------------------------------------------------------
+  Helper Functions
+----------------------------------------------------------------------*/
+
+static void usage () {
+  cout << "usage: plimage infile [outfile]" << '\n';
+  cout << "infile     a program image, which is written out as text (one"
+       << '\n'
+       << "           word per line), or text, which is written out as an"
+       << '\n'
+       << "           image (text has no line numbers to carry over)"
+       << '\n';
+  cout << "outfile    file to write to (default stdout)" << '\n';
+}
+
+/* --------------------------------------------------------------------*/
+
+static bool space (char c) {
+  return ' ' == c || ('\t' <= c && c <= '\r');
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- image to text */
+static int to_text (char const *fn, ostream & out) {
+  image::program program;
+  if (!program.load (fn)) {
+    cerr << "plimage: " << fn << ": not a valid program image\n";
+    return EXIT_FAILURE;
+  }
+  int const *code = program.code ();
+  char       b[16];
+  for (size_t i = 0; i < program.words (); ++i) {
+    char *end = std::to_chars (b, b + sizeof (b) - 1, code[i]).ptr;
+    *end++ = '\n';
+    out.write (b, end - b);
+  }
+  return out.flush () ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- text to image */
+static int to_image (char const *fn, ostream & out) {
+  ifstream    in (fn, ifstream::in | ifstream::binary);
+  string      text ((istreambuf_iterator<char> (in)),
+		    istreambuf_iterator<char> ());
+  char const *p = text.data (), *end = p + text.size ();
+  vector<int> code;
+  int         word, line = 1;
+  for (;;) {
+    while (p < end && space (*p)) {
+      line += '\n' == *p++;
+    }
+    if (p == end) {
+      break;
+    }
+    std::from_chars_result r = from_chars (p, end, word);
+    if (r.ec != std::errc () || (r.ptr < end && !space (*r.ptr))) {
+      cerr << "plimage: " << fn << ":" << line << ": integer expected\n";
+      return EXIT_FAILURE;
+    }
+    code.push_back (word);
+    p = r.ptr;
+  }
+  vector<image::line> lines;
+  return image::write (out, code, lines) && out.flush ()
+    ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/*----------------------------------------------------------------------
+  Main Functions
+----------------------------------------------------------------------*/
+
+int main (int argc, char *argv[]) { /* --- main function */
+  if (argc < 2 || argc > 3) {
+    usage ();
+    return argc < 2 ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+  ifstream probe (argv[1]);
+  if (!probe.good ()) {
+    cerr << "plimage: cannot open file " << argv[1] << '\n';
+    return EXIT_FAILURE;
+  }
+  probe.close ();
+
+  ofstream fout;
+  if (3 == argc) {
+    fout.open (argv[2], ofstream::out | ofstream::binary);
+    if (!fout.good ()) {
+      cerr << "plimage: cannot open file " << argv[2] << '\n';
+      return EXIT_FAILURE;
+    }
+  }
+  ostream & out = 3 == argc ? static_cast<ostream&> (fout) : cout;
+  return image::is_image (argv[1]) ? to_text (argv[1], out)
+    : to_image (argv[1], out);
+}
@@ -3,6 +3,12 @@
   Contents: 
   Author  : Ben Burnett
   History : 10.01.2007 file created
+            18.10.2026 no longer counts lines; see source::line ()
+            18.10.2026 tokens are scanned by a DFA built at compile
+	               time; the hand-written scanner is kept, for
+		       comparison, behind --legacy-scanner
+            18.10.2026 large sources can be scanned in pieces, on
+	               several threads
 ----------------------------------------------------------------------*/
 
 #if HAVE_CONFIG_H
@@ -11,15 +17,24 @@
 
 #include "scanner.h"
 #include "misc.h"
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <cassert>
+#include <functional>
+#include <thread>
+#include <vector>
+#ifdef HAVE_SIMD_SKIP
+#include <immintrin.h>
+#endif
 
 /*----------------------------------------------------------------------
   Namespace Inclusions
 ----------------------------------------------------------------------*/
 
 using std::string;
-using std::ifstream;
+using std::thread;
+using std::vector;
 
 /*----------------------------------------------------------------------
   Constants
@@ -37,6 +52,197 @@ static const int symbols[] = { '.', ',', ';', '[', ']', '&', '|', '~',
 /* --- all "whitespace" characters --- */
 static const int wschars[] = { ' ', '\t', '\n' };
 
+/* --- sources smaller than this are always scanned on one thread */
+static const size_t parallel_threshold = 1 << 20;
+
+/*----------------------------------------------------------------------
+  White-space Skipping - white-space is ' ', '\t' and '\n' (as above).
+  Each skipper takes the text to skip in, and returns the first
+  character that is not white-space (or the end).
+----------------------------------------------------------------------*/
+
+static char const* skip_ws_scalar (char const *p, char const *end) {
+  while (p < end && (' ' == *p || '\t' == *p || '\n' == *p)) {
+    ++p;
+  }
+  return p;
+}
+
+/* --------------------------------------------------------------------*/
+
+#ifdef HAVE_SIMD_SKIP
+
+/* --- SSE2 is always there on x86-64: 16 bytes at a time, then the
+   tail byte by byte */
+static char const* skip_ws_sse2 (char const *p, char const *end) {
+  const __m128i space = _mm_set1_epi8 (' '), tab = _mm_set1_epi8 ('\t'),
+                newline = _mm_set1_epi8 ('\n');
+  while (end - p >= 16) {
+    __m128i  v  = _mm_loadu_si128 (reinterpret_cast<__m128i const*> (p));
+    unsigned ws = _mm_movemask_epi8 (
+      _mm_or_si128 (_mm_or_si128 (_mm_cmpeq_epi8 (v, space),
+				  _mm_cmpeq_epi8 (v, tab)),
+		    _mm_cmpeq_epi8 (v, newline)));
+    if (0xffff != ws) {         /* -- the run ends in this block */
+      return p + __builtin_ctz (~ws);
+    }
+    p += 16;
+  }
+  return skip_ws_scalar (p, end);
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- AVX2, where the CPU has it: 32 bytes at a time */
+__attribute__ ((target ("avx2")))
+static char const* skip_ws_avx2 (char const *p, char const *end) {
+  const __m256i space = _mm256_set1_epi8 (' '), 
+                tab = _mm256_set1_epi8 ('\t'),
+                newline = _mm256_set1_epi8 ('\n');
+  while (end - p >= 32) {
+    __m256i  v  = _mm256_loadu_si256 (reinterpret_cast<__m256i const*> (p));
+    unsigned ws = _mm256_movemask_epi8 (
+      _mm256_or_si256 (_mm256_or_si256 (_mm256_cmpeq_epi8 (v, space),
+					_mm256_cmpeq_epi8 (v, tab)),
+		       _mm256_cmpeq_epi8 (v, newline)));
+    if (0xffffffff != ws) {     /* -- the run ends in this block */
+      return p + __builtin_ctz (~ws);
+    }
+    p += 32;
+  }
+  return skip_ws_sse2 (p, end);
+}
+
+#endif
+
+/* --------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------
+  Lexer Automaton - a DFA over byte classes, built by the compiler.
+  A token is scanned by following transitions from the start state for
+  as long as there is one (the longest match); the state it stops in
+  says what was scanned.  White-space and comments are skipped before
+  the automaton is started, so it only ever sees the first character
+  of a token.
+----------------------------------------------------------------------*/
+
+namespace lexer {
+
+  /* --- byte classes: the symbols each have a class of their own */
+  enum byte_class {
+    other, letter, digit, space, period, comma, semicolon, lbracket,
+    rbracket, ampersand, bar, tilde, less, equal, greater, plus, minus,
+    star, slash, backslash, lparen, rparen, colon, dollar, CLASSES
+  };
+
+  /* --- states; dead (0) is where there is no transition.  The states
+     that can go on come first: from the others (most tokens are one
+     character) the scan ends without looking at the next character */
+  enum state {
+    dead, start, word, numeral, s_lbracket, s_minus, s_colon, 
+    FINAL, unknown = FINAL, s_period, s_comma, s_semicolon,
+    s_guard_separator, s_rbracket, s_and, s_or, s_not, s_less, s_equal, 
+    s_greater, s_plus, s_guard_point, s_multiply, s_modulo, s_divide, 
+    s_lparen, s_rparen, s_assign, STATES
+  };
+
+  /* --- the transitions are worked out per class, then spread over
+     every byte, so that a step is a single lookup */
+  struct automaton {
+    unsigned char klass[256];              /* class of each byte */
+    unsigned char next[STATES][CLASSES];   /* transitions, by class */
+    unsigned char step[FINAL][256];        /* transitions, by byte */
+    token_code    accept[STATES];          /* what each state scanned */
+  };
+
+  /* --- a single character symbol: start --c--> s, which accepts t */
+  constexpr void symbol (automaton & a, byte_class c, state s,
+			 token_code t) {
+    a.next[start][c] = s;
+    a.accept[s]      = t;
+  }
+
+  constexpr automaton build () {
+    automaton a {};
+    for (int s = 0; s < STATES; ++s) {
+      a.accept[s] = UNKNOWN;
+    }
+    for (int c = 'a'; c <= 'z'; ++c) {
+      a.klass[c] = letter;
+    }
+    for (int c = 'A'; c <= 'Z'; ++c) {
+      a.klass[c] = letter;
+    }
+    for (int c = '0'; c <= '9'; ++c) {
+      a.klass[c] = digit;
+    }
+    a.klass['_']  = letter;
+    a.klass[' ']  = a.klass['\t'] = a.klass['\n'] = space;
+    a.klass['.']  = period;    a.klass[',']  = comma;
+    a.klass[';']  = semicolon; a.klass['[']  = lbracket;
+    a.klass[']']  = rbracket;  a.klass['&']  = ampersand;
+    a.klass['|']  = bar;       a.klass['~']  = tilde;
+    a.klass['<']  = less;      a.klass['=']  = equal;
+    a.klass['>']  = greater;   a.klass['+']  = plus;
+    a.klass['-']  = minus;     a.klass['*']  = star;
+    a.klass['/']  = slash;     a.klass['\\'] = backslash;
+    a.klass['(']  = lparen;    a.klass[')']  = rparen;
+    a.klass[':']  = colon;     a.klass['$']  = dollar;
+
+    /* -- anything unrecognized is a one character UNKNOWN token */
+    for (int c = 0; c < CLASSES; ++c) {
+      a.next[start][c] = unknown;
+    }
+
+    /* -- words and numerals */
+    a.next[start][letter] = a.next[word][letter] = a.next[word][digit] = word;
+    a.next[start][digit]  = a.next[numeral][digit] = numeral;
+    a.accept[word]        = IDENTIFIER;
+    a.accept[numeral]     = NUMBER;
+
+    /* -- symbols (note '/' is MODULO and '\' DIVIDE, as in scan_symbol) */
+    symbol (a, period,    s_period,    PERIOD);
+    symbol (a, comma,     s_comma,     COMMA);
+    symbol (a, semicolon, s_semicolon, SEMICOLON);
+    symbol (a, lbracket,  s_lbracket,  LEFT_BRACKET);
+    symbol (a, rbracket,  s_rbracket,  RIGHT_BRACKET);
+    symbol (a, ampersand, s_and,       LOGICAL_AND);
+    symbol (a, bar,       s_or,        LOGICAL_OR);
+    symbol (a, tilde,     s_not,       LOGICAL_NOT);
+    symbol (a, less,      s_less,      LESS_THAN);
+    symbol (a, equal,     s_equal,     EQUAL);
+    symbol (a, greater,   s_greater,   GREATER_THAN);
+    symbol (a, plus,      s_plus,      PLUS);
+    symbol (a, minus,     s_minus,     MINUS);
+    symbol (a, star,      s_multiply,  MULTIPLY);
+    symbol (a, slash,     s_modulo,    MODULO);
+    symbol (a, backslash, s_divide,    DIVIDE);
+    symbol (a, lparen,    s_lparen,    LEFT_PAREN);
+    symbol (a, rparen,    s_rparen,    RIGHT_PAREN);
+    symbol (a, colon,     s_colon,     UNKNOWN); /* (no ':' in PL) */
+
+    /* -- and the two character ones: "[]", "->" and ":=" */
+    a.next[s_lbracket][rbracket] = s_guard_separator;
+    a.next[s_minus][greater]     = s_guard_point;
+    a.next[s_colon][equal]       = s_assign;
+    a.accept[s_guard_separator]  = GUARD_SEPARATOR;
+    a.accept[s_guard_point]      = GUARD_POINT;
+    a.accept[s_assign]           = ASSIGN;
+
+    for (int s = 0; s < FINAL; ++s) {
+      for (int c = 0; c < 256; ++c) {
+	a.step[s][c] = a.next[s][a.klass[c]];
+      }
+    }
+    return a;
+  }
+
+  static constexpr automaton dfa = build ();
+
+}
+
+/* --------------------------------------------------------------------*/
+
 /*----------------------------------------------------------------------
   Friend Functions/Operators
 ----------------------------------------------------------------------*/
@@ -45,10 +251,11 @@ static const int wschars[] = { ' ', '\t', '\n' };
   Main Methods
 ----------------------------------------------------------------------*/
 
-scanner::scanner (ifstream & s)
-  : _fin (s), _column (0), _line (1) {
+scanner::scanner (source const & s)
+  : _source (s), _p (NULL), _end (NULL), _skip_ws (select_skip_ws ()),
+    _legacy (false), _intern (true) {
   unsigned int i;
-  for (i = 0; i < 128; ++i) {
+  for (i = 0; i < count_of (_char_map); ++i) {
     _char_map[i] = character::error;
   }
   for (i = 'a'; i <= 'z'; ++i) {
@@ -96,88 +303,80 @@ bool scanner::isnumeral (int c) const { /* --- return true if a number */
 
 /* --------------------------------------------------------------------*/
 
-void scanner::get (char & c) { /* --- get the next character from */
-  _fin.get (c);                /* the input stream; incrementing the */
-  _column++;                     /* location and line counter as we go */
-  if ('\n' == c) {
-    _line++;
-    _column = 0;
-  }
+/* --- the white-space skipper for this machine */
+scanner::skip_function scanner::select_skip_ws () {
+#ifdef HAVE_SIMD_SKIP
+  __builtin_cpu_init ();
+  return __builtin_cpu_supports ("avx2") ? skip_ws_avx2 : skip_ws_sse2;
+#else
+  return skip_ws_scalar;
+#endif
 }
 
 /* --------------------------------------------------------------------*/
 
-void scanner::putback (char c) { /* --- put the last character back into */
-  _fin.putback (c);              /* the input stream; decrementing the */
-  _column--;                       /* location and line counter as we go */
-  if ('\n' == c) {
-    _line--;
-  }
+/* --- the next character, without consuming it (EOF at the end) */
+int scanner::peek () const {
+  return _p < _end ? static_cast<unsigned char> (*_p) : EOF;
 }
 
 /* --------------------------------------------------------------------*/
 
-char scanner::peek () {
-  return _fin.peek ();
+void scanner::skipws () {       /* --- skip over white space */
+  if (_p < _end && iswhite (static_cast<unsigned char> (*_p))) {
+    _p = _skip_ws (_p, _end);
+  }
 }
 
 /* --------------------------------------------------------------------*/
 
-void scanner::skipws () {       /* --- skip over white space */
-  char c;
-  while (iswhite (peek ())) {
-    get (c);                  /* consume and discard the character */
-  }
+void scanner::skip_comment () { /* --- skip to the end of the line (the */
+  char const *nl = static_cast<char const*> ( /* newline is left as */
+    memchr (_p, '\n', _end - _p)); /* white-space); memchr is vectorized */
+  _p = nl ? nl : _end;          /* in the C library */
 }
 
 /* --------------------------------------------------------------------*/
 
-void scanner::scan_word () {
-  char c;
-  string s;
-  while (iswordchar (peek ())) { 
-    get (c); 
-    s += c;
-  }
-  symboltbl::iterator it = _symbols.find (s);
-    if (it == _symbols.end ()) {    /* if not in symbol table, then */
-    _token = token (IDENTIFIER, s); /* it's an identifier, so create a */
-    _symbols.insert (s, _token);    /* new entry in the symbol table */
-  } else {
-    _token = it->second;
+void scanner::scan_word () {    /* --- words are interned as they lie */
+  char const *start = _p;       /* in the source: the keywords are the */
+  while (_p < _end && iswordchar (static_cast<unsigned char> (*_p))) { 
+    ++_p;                       /* first atoms, anything else is an */
+  }                             /* identifier */
+  if (!_intern) {
+    _token = make_token (IDENTIFIER, atom::none, start);
+    return;
   }
+  atom::id a = atom::intern (start, _p - start);
+  _token = make_token (atom::keyword (a), a, start);
 }
 
 /* --------------------------------------------------------------------*/
 
-void scanner::scan_numeral () {
-  char c;
-  string s;
-  while (isnumeral (peek ())) { 
-    get (c); 
-    s += c;
+void scanner::scan_numeral () { /* --- the value is accumulated as the */
+  char const  *start = _p;      /* digits are scanned (wrapping, as */
+  unsigned int x = 0;
+  while (_p < _end && isnumeral (static_cast<unsigned char> (*_p))) { 
+    x = 10 * x + (*_p++ - '0'); /* atoi would) */
   }  
-  _token = token (NUMBER, ::atoi (s.c_str ()));  
+  _token = make_token (NUMBER, static_cast<int> (x), start);
 }
 
 /* --------------------------------------------------------------------*/
 
 void scanner::scan_symbol () {
-  char c;
-  string s;
+  char const *start = _p;
   token_code code;
   code = UNKNOWN;
-  get ( c );  
-  switch ( c ) {
+  switch (*_p++) {
   case '.': code = PERIOD;         break;
   case ',': code = COMMA;          break;
   case ';': code = SEMICOLON;      break;
   case '[': 
     code = LEFT_BRACKET;    
     if (']' == peek ()) {     /* [] */
-      s += '[';
       code = GUARD_SEPARATOR;
-      get (c);                /* eat next char */
+      ++_p;                   /* eat next char */
     } break;
   case ']': code = RIGHT_BRACKET;  break;
   case '&': code = LOGICAL_AND;    break;
@@ -190,9 +389,8 @@ void scanner::scan_symbol () {
   case '-': 
     code = MINUS;
     if ('>' == peek ()) {     /* -> */
-      s += '-';
       code = GUARD_POINT;
-      get (c);                /* eat next char */
+      ++_p;                   /* eat next char */
     } break;
   case '*':  code = MULTIPLY;      break;
   case '/':  code = MODULO;        break;
@@ -202,9 +400,8 @@ void scanner::scan_symbol () {
   case ':':    
     code = UNKNOWN;             /* no ':' symbol in PL ... */      
     if ('=' == peek ()) {     /* := */
-      s += ':';
       code = ASSIGN;
-      get (c);                /* eat next char */      
+      ++_p;                   /* eat next char */      
     } break;
   default:
     code = UNKNOWN;
@@ -214,33 +411,88 @@ void scanner::scan_symbol () {
     break;
   }  
   /* --- finally, create the token object */
-  _token = token (code, s += c);
+  _token = make_token (code, 0, start);
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- scan a token with the automaton: one table lookup per character,
+   whatever the token turns out to be.  The value of a numeral is worked
+   out along the way, for every token (it is only kept for numerals);
+   that is cheaper than going back over the digits */
+void scanner::scan_token () {
+  char const  *start = _p, *p = _p, *end = _end;
+  unsigned int x = *p - '0';    /* (wrapping, as atoi would) */
+  int          s = lexer::dfa.step[lexer::start][
+		     static_cast<unsigned char> (*p++)], n;
+  while (s < lexer::FINAL && p < end 
+	 && (n = lexer::dfa.step[s][static_cast<unsigned char> (*p)])) {
+    s = n;
+    x = 10 * x + (*p++ - '0');
+  }
+  _p = p;
+  token_code code = lexer::dfa.accept[s];
+  if (IDENTIFIER == code && _intern) { /* -- words are interned, as */
+    atom::id a = atom::intern (start, p - start); /* they lie */
+    _token = make_token (atom::keyword (a), a, start);
+  } else {
+    _token = make_token (code, NUMBER == code ? static_cast<int> (x) : 0, 
+			 start);
+  }
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- a token for the text from start up to the next character */
+token scanner::make_token (token_code c, int value, 
+			   char const *start) const {
+  return token (c, value, start - _source.begin (), _p - start);
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- the text a token was scanned from */
+string scanner::text (token const & t) const {
+  return string (_source.begin () + t.offset (), t.length ());
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- start scanning from the beginning of the source */
+void scanner::start () {
+  start (_source.begin (), _source.end ());
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- or from somewhere in it, stopping short of its end */
+void scanner::start (char const *from, char const *to) {
+  _p   = from;
+  _end = to;
 }
 
 /* --------------------------------------------------------------------*/
 
 /* --- return the next token */
 token const & scanner::next_token () { 
-  char d; string s;
-  skipws ();                    /* -- skip all white-space, then based on */  
-  int c = peek ();              /* the first character we decide how to */
-  switch (c) {                /* continue scanning from here */
-  case EOF:    
-    _token = token::eof_token;  /* -- looks like we are done, let the */
-    break;                      /* higher level processors know */
-  case '$':    
-    while ('\n' != peek ()) { /* -- we treat comments as white-space */
-      get (d); }              /* and pass it by, then we look for the */ 
-    return next_token ();       /* next token in the input stream */
-    break;
-  default:
+  int c;
+  skipws ();                    /* -- skip all white-space and comments, */
+  while ('$' == (c = peek ())) { /* then based on the first character */
+    skip_comment ();            /* we decide how to continue scanning */
+    skipws ();                  /* from here */
+  }
+  if (EOF == c) {
+    _token = make_token (END_OF_FILE, 0, _p); /* -- looks like we are */
+  } else if (!_legacy) {        /* done, let the higher levels know */
+    scan_token ();
+  } else {
     switch (_char_map[c]) {     
     case character::letter: scan_word ();    break; 
     case character::digit:  scan_numeral (); break;
     case character::symbol: scan_symbol ();  break;
     default: 
-      _token = token (UNKNOWN, s += c);
-      get (d);                /* consume the unknown character */
+      ++_p;                     /* consume the unknown character */
+      _token = make_token (UNKNOWN, 0, _p - 1);
       break;
     } 
   }
@@ -249,13 +501,106 @@ token const & scanner::next_token () {
 
 /* --------------------------------------------------------------------*/
 
-unsigned int scanner::line () const {
-  return _line;
+/* --- scan with the original, hand-written scanner (to compare the
+   two), or with the automaton */
+void scanner::legacy (bool on) {
+  _legacy = on;
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- scan part of the source in to a buffer, up to and including its
+   END_OF_FILE token */
+void scanner::scan_range (char const *from, char const *to,
+			  token_buffer & tokens) {
+  start (from, to);
+  tokens.clear ();
+  tokens.reserve ((to - from) / 2 + 1); /* (about as many as there are) */
+  do {
+    tokens.push_back (next_token ());
+  } while (END_OF_FILE != _token);
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- scan the whole source, from the top, in to a buffer.  A large
+   source may be scanned on several threads: no token or comment goes
+   past the end of a line, so the source is cut in to pieces just after
+   a newline, and each piece is scanned by a scanner of its own.  The
+   atom table is not shared between threads, so the words are left for
+   this thread to intern as the pieces are joined; offsets are from the
+   start of the source, whichever piece they were found in */
+void scanner::scan_all (token_buffer & tokens, unsigned int threads) {
+  char const *begin = _source.begin (), *end = _source.end ();
+  if (threads < 2 || _source.size () < parallel_threshold) {
+    scan_range (begin, end, tokens);
+    return;
+  }
+
+  /* --- cut the source in to pieces --- */
+  vector<char const*> cut (1, begin);
+  for (unsigned int i = 1; i < threads; ++i) {
+    char const *p = begin + _source.size () / threads * i;
+    if (p < cut.back ()) {
+      continue;                 /* (a line longer than a piece) */
+    }
+    p = static_cast<char const*> (memchr (p, '\n', end - p));
+    if (!p) {
+      break;
+    }
+    cut.push_back (p + 1);
+  }
+  cut.push_back (end);
+
+  /* --- scan them, the first on this thread --- */
+  size_t               n = cut.size () - 1;
+  scanner              prototype (*this);
+  prototype._intern = false;
+  vector<scanner>      scanners (n, prototype);
+  vector<token_buffer> pieces (n);
+  vector<thread>       workers;
+  for (size_t i = 1; i < n; ++i) {
+    workers.push_back (thread (&scanner::scan_range, &scanners[i], cut[i],
+			       cut[i + 1], std::ref (pieces[i])));
+  }
+  scanners[0].scan_range (cut[0], cut[1], pieces[0]);
+  for (size_t i = 0; i < workers.size (); ++i) {
+    workers[i].join ();
+  }
+
+  /* --- and join them, interning the words, with only the last
+     piece's END_OF_FILE --- */
+  size_t total = 0;
+  for (size_t i = 0; i < n; ++i) {
+    total += pieces[i].size ();
+  }
+  tokens.clear ();
+  tokens.reserve (total - n + 1);
+  for (size_t i = 0; i < n; ++i) {
+    token_buffer const & piece = pieces[i];
+    size_t last = piece.size () - (i + 1 < n);
+    for (size_t j = 0; j < last; ++j) {
+      token t = piece[j];
+      if (IDENTIFIER == t) {
+	atom::id a = atom::intern (begin + t.offset (), t.length ());
+	t = token (atom::keyword (a), a, t.offset (), t.length ());
+      }
+      tokens.push_back (t);
+    }
+  }
+  _token = tokens[tokens.size () - 1];
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- the line and column of an offset in the source */
+unsigned int scanner::line (unsigned int offset) const {
+  return _source.line (offset);
 }
 
 /* --------------------------------------------------------------------*/
 
-unsigned int scanner::column () const {
-  return _column;
+unsigned int scanner::column (unsigned int offset) const {
+  return _source.column (offset);
 }
 
@@ -8,19 +8,22 @@
 #ifndef SCANNER_H
 #define SCANNER_H
 
-#include "symboltbl.h"
+#include "atoms.h"
+#include "source.h"
 #include "token.h"
+#include "tokens.h"
 #include "error.h"
 #include <stdexcept>
-#include <fstream>
 #include <string>
 
 /*----------------------------------------------------------------------
-  Forward Declarations
+  Preprocessor Definitions
 ----------------------------------------------------------------------*/
 
-class token;
-class symboltbl;
+/* --- white-space can be skipped 16 or 32 bytes at a time on x86-64 */
+#if defined (__x86_64__) && defined (__GNUC__)
+#define HAVE_SIMD_SKIP 1
+#endif
 
 /*----------------------------------------------------------------------
   Character Codes
@@ -44,32 +47,48 @@ class scanner {
 
 private:
   
-  std::ifstream & _fin;         /* input stream reference */
-  symboltbl       _symbols;     /* main symbol table */
+  source const &  _source;      /* the source text */
+  char const     *_p;           /* next character to scan */
+  char const     *_end;         /* end of the source text */
   character::code _char_map[256];/* character characterization map */
-  unsigned int    _column,      /* current column number */
-                  _line;        /* current line number */  
   token           _token;       /* current token */
+
+  /* --- a white-space skipper: returns the first character that is not
+     white-space */
+  typedef char const* (*skip_function) (char const*, char const*);
+  skip_function   _skip_ws;     /* the fastest this machine can do */
+  bool            _legacy;      /* scan with the hand-written scanner */
+  bool            _intern;      /* intern words (or leave that to later) */
+
+  static skip_function select_skip_ws ();
   
   bool iswhite (int) const;
   bool iswordchar (int) const;
   bool isnumeral (int) const;
   
   void skipws ();
-  void get (char &);
-  void putback (char);
-  char peek ();
+  void skip_comment ();
+  int peek () const;
 
   void scan_word ();
   void scan_numeral ();
   void scan_symbol ();
+  void scan_token ();
+
+  token make_token (token_code, int, char const*) const;
+  void start (char const*, char const*);
+  void scan_range (char const*, char const*, token_buffer&);
 
 public:
 
-  scanner (std::ifstream &);  
+  scanner (source const &);  
+  void start ();
   token const & next_token ();
-  unsigned int line () const;
-  unsigned int column () const;   
+  void scan_all (token_buffer&, unsigned int = 1);
+  void legacy (bool);
+  std::string text (token const&) const;
+  unsigned int line (unsigned int) const;
+  unsigned int column (unsigned int) const;   
   
 };
 
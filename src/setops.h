@@ -6,47 +6,78 @@
   History : 18.02.2007 file created
             21.02.2007 added make_set function to build sets on the 
 	               fly.
+            18.10.2026 token sets are now bitsets, built at compile 
+	               time where possible.
 ----------------------------------------------------------------------*/
 
 #ifndef SET_OPERATIONS_H
 #define SET_OPERATIONS_H
 
 #include "token.h"
-#include <set>
 
 /*----------------------------------------------------------------------
   Type Definitions
 ----------------------------------------------------------------------*/
 
-typedef std::set<token_code> token_set;
+/* --- a set of token codes: there are fewer than 64 of them (counting
+   NONE), so a set is a single word, with one bit per code.  Building,
+   joining and testing sets never allocates, and all of it can be done
+   by the compiler when the members are constants */
+class token_set {
+
+ private:
+
+  unsigned long long _bits;
+
+  static constexpr unsigned long long bit (int c) {
+    return 1ULL << (c - FIRST_TOKEN);
+  }
+
+  constexpr explicit token_set (unsigned long long bits) : _bits (bits) {}
+
+ public:
+
+  constexpr token_set () : _bits (0) {}
+
+  /* --- the set's union with a single code */
+  constexpr token_set with (int c) const {
+    return token_set (_bits | bit (c));
+  }
+
+  /* --- 1 if the code is a member, 0 otherwise (as std::set) */
+  constexpr int count (token_code c) const {
+    return (_bits & bit (c)) ? 1 : 0;
+  }
+
+  constexpr bool empty () const { return 0 == _bits; }
+
+  /* -- enable the creating unions of two set by adding them */
+  constexpr token_set operator + (token_set const & b) const {
+    return token_set (_bits | b._bits);
+  }
+
+  constexpr bool operator == (token_set const & b) const {
+    return _bits == b._bits;
+  }
+
+};
+
+static_assert (LAST_TOKEN - FIRST_TOKEN <= 64,
+	       "token codes no longer fit in a token_set");
 
 /*----------------------------------------------------------------------
   Functions
 ----------------------------------------------------------------------*/
 
-/* -- enable the creating unions of two set by adding them */
-token_set operator + (token_set const & a, token_set const & b);
-
-/* --------------------------------------------------------------------*/
-
-/* -- set builder implementation: all other set builder functions
-   call this on internally.  It takes a variable number of arguments
-   of type T and returns a set */ 
-token_set make_set_impl (int n, ...);
-
-/* -- build sets of varible length */
-token_set make_set (int a);
-token_set make_set (int a, int b);
-token_set make_set (int a, int b, int c);
-token_set make_set (int a, int b, int c, int d);
-token_set make_set (int a, int b, int c, int d, int e);
-token_set make_set (int a, int b, int c, int d, int e, int f);
-token_set make_set (int a, int b, int c, int d, int e, int f, int g);
-token_set make_set (int a, int b, int c, int d, int e, int f, int g, int h);
-token_set make_set (int a, int b, int c, int d, int e, int f, int g, int h, 
-		     int i);
-token_set make_set (int a, int b, int c, int d, int e, int f, int g, int h, 
-		     int i, int j);
+/* -- build sets of variable length: make_set (COMMA, END, PLUS) */
+constexpr token_set make_set () {
+  return token_set ();
+}
+
+template <typename... Codes>
+constexpr token_set make_set (int a, Codes... rest) {
+  return make_set (rest...).with (a);
+}
 
 #endif
 
@@ -0,0 +1,144 @@
+/*----------------------------------------------------------------------
+  File    : source.cc
+  Contents: Source text, held in one contiguous buffer
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+            18.10.2026 lines and columns are found from offsets, through
+	               an index of the newlines built when first needed
+----------------------------------------------------------------------*/
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "source.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*----------------------------------------------------------------------
+  Constants
+----------------------------------------------------------------------*/
+
+static const size_t block_size = 65536; /* read size, for unmappables */
+static const size_t near       = 8;     /* newlines walked before a search */
+
+/*----------------------------------------------------------------------
+  Main Methods
+----------------------------------------------------------------------*/
+
+source::source ()
+  : _begin (NULL), _end (NULL), _map (NULL), _size (0), _indexed (false),
+    _hint (0) {
+}
+
+/* --------------------------------------------------------------------*/
+
+source::~source () {
+  close ();
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- load the file; false if it cannot be opened */
+bool source::open (char const *fn) {
+  close ();
+  int fd = fn ? ::open (fn, O_RDONLY) : STDIN_FILENO;
+  if (-1 == fd) {
+    return false;
+  }
+  struct stat st;
+  if (0 == fstat (fd, &st) && S_ISREG (st.st_mode) && st.st_size > 0) {
+    void *p = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (MAP_FAILED != p) {
+      madvise (p, st.st_size, MADV_SEQUENTIAL);
+      _map   = p;
+      _size  = st.st_size;
+      _begin = static_cast<char const*> (p);
+      _end   = _begin + st.st_size;
+    }
+  }
+  if (!_map) {
+    ssize_t n;
+    size_t  used = 0;
+    do {                        /* -- read straight in to the buffer, */
+      _text.resize (used + block_size); /* a block at a time */
+      n = read (fd, &_text[used], block_size);
+      used += n > 0 ? n : 0;
+    } while (n > 0);
+    _text.resize (used);
+    _begin = _text.data ();
+    _end   = _begin + used;
+  }
+  if (fn) {
+    ::close (fd);
+  }
+  return true;
+}
+
+/* --------------------------------------------------------------------*/
+
+void source::close () {
+  if (_map) {
+    munmap (_map, _size);
+  }
+  _map  = NULL;
+  _size = 0;
+  _text.clear ();
+  _begin = _end = NULL;
+  _newlines.clear ();
+  _indexed = false;
+  _hint    = 0;
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- the number of newlines before an offset.  The offsets asked about
+   mostly move forward a little at a time (the parser asks as it goes),
+   so the search starts from where the last one ended */
+size_t source::newlines_before (size_t offset) const {
+  if (!_indexed) {
+    for (char const *p = _begin; p < _end; ++p) {
+      p = static_cast<char const*> (memchr (p, '\n', _end - p));
+      if (!p) {
+	break;
+      }
+      _newlines.push_back (p - _begin);
+    }
+    _indexed = true;
+  }
+  std::vector<unsigned>::const_iterator first = _newlines.begin (), 
+    last = _newlines.end ();
+  size_t i = _hint;
+  if (i > 0 && _newlines[i - 1] >= offset) {
+    last = first + i;           /* -- behind the last one: search back */
+  } else {
+    for (size_t n = 0; i < _newlines.size () && _newlines[i] < offset; 
+	 ++i) {
+      if (++n == near) {        /* -- too far ahead to walk: search */
+	first += i;
+	break;
+      }
+    }
+    if (first == _newlines.begin ()) {
+      return _hint = i;
+    }
+  }
+  return _hint = std::lower_bound (first, last, offset) - _newlines.begin ();
+}
+
+/* --------------------------------------------------------------------*/
+
+unsigned source::line (size_t offset) const {
+  return newlines_before (offset) + 1;
+}
+
+/* --------------------------------------------------------------------*/
+
+unsigned source::column (size_t offset) const {
+  size_t n = newlines_before (offset);
+  return offset - (n ? _newlines[n - 1] + 1 : 0) + 1;
+}
@@ -0,0 +1,72 @@
+/*----------------------------------------------------------------------
+  File    : source.h
+  Contents: Source text, held in one contiguous buffer
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+            18.10.2026 lines and columns are found from offsets, through
+	               an index of the newlines built when first needed
+----------------------------------------------------------------------*/
+
+#ifndef SOURCE_H
+#define SOURCE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/*----------------------------------------------------------------------
+  Main Class
+----------------------------------------------------------------------*/
+
+/* --- the whole of an input file, as a range of characters: regular
+   files are mapped in to memory and used where they lie; anything that
+   cannot be mapped (a pipe, say) is read in, a block at a time.
+
+   Positions in the source are byte offsets.  Nothing counts lines while
+   scanning: the first time a line or column is asked for, the offsets
+   of the newlines are collected (with memchr), and each question after
+   that is answered from them */
+class source {
+
+private:
+
+  char const  *_begin;          /* first character */
+  char const  *_end;            /* one past the last character */
+  void        *_map;            /* file mapping (or NULL) */
+  size_t       _size;           /* size of the mapping */
+  std::string  _text;           /* the source, when it was read */
+
+  mutable std::vector<unsigned> _newlines; /* offset of every newline */
+  mutable bool   _indexed;      /* has _newlines been built? */
+  mutable size_t _hint;         /* newlines before the last offset asked */
+
+  size_t newlines_before (size_t) const;
+
+  source (source const&);
+  source& operator= (source const&);
+
+public:
+
+  source ();
+  ~source ();
+
+  bool open (char const*);      /* NULL for stdin */
+  void close ();
+
+  char const* begin () const    { return _begin; }
+  char const* end () const      { return _end; }
+  size_t      size () const     { return _end - _begin; }
+
+  unsigned    line (size_t) const;   /* line of an offset, from 1 */
+  unsigned    column (size_t) const; /* column of an offset, from 1 */
+
+};
+
+#endif
+
+/*----------------------------------------------------------------------
+  Emacs Configuration
+  Local Variables:
+  mode: C++
+  End:
+----------------------------------------------------------------------*/
@@ -0,0 +1,155 @@
+/*----------------------------------------------------------------------
+  File    : spelling.cc
+  Contents: An index of names, for spelling suggestions
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "spelling.h"
+#include <cctype>
+#include <cstring>
+
+/*----------------------------------------------------------------------
+  Namespace Inclusions
+----------------------------------------------------------------------*/
+
+using std::vector;
+
+/*----------------------------------------------------------------------
+  Constants
+----------------------------------------------------------------------*/
+
+/* --- soundex digits for A to Z ('0' for the letters it ignores) */
+static const char codes[] = "01230120022455012623010202";
+
+/*----------------------------------------------------------------------
+  Main Methods
+----------------------------------------------------------------------*/
+
+/* --- add a name to the index (names already in it are ignored) */
+void spelling::insert (atom::id a) {
+  if (a < 0) {
+    return;
+  }
+  size_t k = a;
+  if (k >= _indexed.size ()) {
+    _indexed.resize (k + 1 > 2 * _indexed.size () 
+		     ? k + 1 : 2 * _indexed.size ());
+  }
+  if (_indexed[a]) {
+    return;
+  }
+  _indexed[a] = true;
+  _sounds[soundex (atom::name (a), atom::length (a))].push_back (a);
+
+  node n = { a, 0, -1, -1 };
+  if (_nodes.empty ()) {
+    _nodes.push_back (n);
+    return;
+  }
+  int i = 0;                    /* -- walk down to the child at the */
+  for (;;) {                    /* same distance, or add one */
+    int d = distance (a, _nodes[i].name), c = _nodes[i].child;
+    while (-1 != c && _nodes[c].distance != d) {
+      c = _nodes[c].sibling;
+    }
+    if (-1 == c) {
+      n.distance = d;
+      n.sibling  = _nodes[i].child;
+      _nodes[i].child = _nodes.size ();
+      _nodes.push_back (n);
+      return;
+    }
+    i = c;
+  }
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- the names within the given edit distance of a name, and the
+   names that sound like it */
+void spelling::candidates (atom::id a, int limit, vector<atom::id> & out) {
+  out.clear ();
+  if (a < 0) {
+    return;
+  }
+  std::unordered_map<unsigned, vector<atom::id> >::const_iterator it 
+    = _sounds.find (soundex (atom::name (a), atom::length (a)));
+  if (it != _sounds.end ()) {
+    out = it->second;
+  }
+  if (_nodes.empty ()) {
+    return;
+  }
+  /* -- by the triangle inequality, only the children whose distance is
+     within limit of the node's own distance can hold a match */
+  vector<int> pending (1, 0);
+  while (!pending.empty ()) {
+    int i = pending.back (), d = distance (a, _nodes[i].name);
+    pending.pop_back ();
+    if (d <= limit) {
+      out.push_back (_nodes[i].name);
+    }
+    for (int c = _nodes[i].child; -1 != c; c = _nodes[c].sibling) {
+      if (_nodes[c].distance >= d - limit && _nodes[c].distance <= d + limit) {
+	pending.push_back (c);
+      }
+    }
+  }
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- Levenshtein distance, one row at a time */
+int spelling::distance (atom::id a, atom::id b) {
+  char const *s = atom::name (a), *t = atom::name (b);
+  size_t      m = atom::length (a), n = atom::length (b);
+  _row.resize (n + 1);
+  int *row = &_row[0];
+  for (size_t j = 0; j <= n; ++j) {
+    row[j] = j;
+  }
+  for (size_t i = 1; i <= m; ++i) {
+    int diagonal = row[0];
+    row[0] = i;
+    for (size_t j = 1; j <= n; ++j) {
+      int above = row[j];
+      int best  = diagonal + (s[i - 1] != t[j - 1]);
+      if (above + 1 < best)      best = above + 1;
+      if (row[j - 1] + 1 < best) best = row[j - 1] + 1;
+      row[j]   = best;
+      diagonal = above;
+    }
+  }
+  return row[n];
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- American soundex: the first letter and three digits, packed in
+   to an integer */
+unsigned spelling::soundex (char const *s, size_t n) {
+  unsigned code = 0;
+  int      digits = 0;
+  char     last = 0;
+  for (size_t i = 0; i < n && digits < 3; ++i) {
+    int c = toupper (static_cast<unsigned char> (s[i]));
+    if (c < 'A' || c > 'Z') {
+      continue;                 /* (digits and underscores) */
+    }
+    char digit = codes[c - 'A'];
+    if (0 == code) {
+      code = c << 24;           /* -- the first letter is kept */
+    } else if ('0' != digit && digit != last) {
+      code |= (digit - '0') << (8 * (2 - digits++));
+    }
+    if ('H' != c && 'W' != c) { /* (H and W do not separate letters */
+      last = digit;             /* with the same code) */
+    }
+  }
+  return code;
+}
@@ -0,0 +1,60 @@
+/*----------------------------------------------------------------------
+  File    : spelling.h
+  Contents: An index of names, for spelling suggestions
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#ifndef SPELLING_H
+#define SPELLING_H
+
+#include "atoms.h"
+#include <unordered_map>
+#include <vector>
+
+/*----------------------------------------------------------------------
+  Main Class - every name that has ever been defined, indexed two ways:
+  by how it sounds (its soundex code), and by edit distance, in a
+  BK-tree.  Looking up the names close to a misspelling only visits the
+  parts of the tree that could be within reach, rather than every name
+  there is.  Names are never removed; whether a name is still in scope
+  is for the symbol table to decide.
+----------------------------------------------------------------------*/
+
+class spelling {
+
+private:
+
+  /* --- a BK-tree node: children are chained through their siblings, 
+     each at its own distance from the parent */
+  struct node {
+    atom::id name;
+    int      distance;          /* from the parent */
+    int      child;             /* first child (or -1) */
+    int      sibling;           /* next child of the parent (or -1) */
+  };
+
+  std::vector<node>     _nodes; /* the tree; the root is the first */
+  std::vector<bool>     _indexed; /* per atom: is it in the index? */
+  std::unordered_map<unsigned, std::vector<atom::id> > _sounds;
+  std::vector<int>      _row;   /* scratch for distance () */
+
+public:
+
+  void insert (atom::id);
+  void candidates (atom::id, int, std::vector<atom::id>&);
+
+  int distance (atom::id, atom::id);
+
+  static unsigned soundex (char const*, size_t);
+
+};
+
+#endif
+
+/*----------------------------------------------------------------------
+  Emacs Configuration
+  Local Variables:
+  mode: C++
+  End:
+----------------------------------------------------------------------*/
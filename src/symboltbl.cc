@@ -10,6 +10,11 @@
 	    19.03.2007 revamped AGAIN, now we use a list of maps, 
 	               don't really know why I didn't do this in the 
 		       first place!
+            18.10.2026 and AGAIN: one table indexed by atom, with
+	               the scopes kept as an undo log, so that a
+		       lookup no longer searches every scope
+            18.10.2026 bindings hold symbol records, and can be
+	               referred to by handle
 ----------------------------------------------------------------------*/
 
 #if HAVE_CONFIG_H
@@ -18,19 +23,14 @@
 
 #include "symboltbl.h"
 #include "misc.h"
-
-
-#include<iostream>
-using namespace std;
+#include <algorithm>
 
 /*----------------------------------------------------------------------
   Namespace Inclusions
 ----------------------------------------------------------------------*/
 
-using std::map;
 using std::make_pair;
 using std::pair;
-using std::string;
 
 /*----------------------------------------------------------------------
   Preprocessor Definitions
@@ -40,28 +40,8 @@ using std::string;
   Constants
 ----------------------------------------------------------------------*/
 
-/* --- all the reserved words in PL programming language */
-static struct {
-  string     word;
-  token_code code;
-} keywords[] = { 
-  { "begin",   BEGIN },
-  { "end",     END },
-  { "const",   CONST },
-  { "array",   ARRAY },
-  { "integer", INTEGER },
-  { "Boolean", BOOLEAN },
-  { "proc",    PROC },
-  { "skip",    SKIP },
-  { "read",    READ },
-  { "write",   WRITE },
-  { "call",    CALL },
-  { "if",      IF },
-  { "do",      DO },
-  { "fi",      FI },
-  { "od",      OD },
-  { "false",   FALSE },
-  { "true",    TRUE }
+const symbol symboltbl::undefined = { 
+  kind::undefined, type::universal, 0, 1, 0, 0, -1 
 };
 
 /*----------------------------------------------------------------------
@@ -72,98 +52,155 @@ static struct {
   Main Methods
 ----------------------------------------------------------------------*/
 
-symboltbl::symboltbl () : _current (_contents.begin ()) {
-  push ();
-  /* --- insert all the reserved words in to the symbol table */  
-  for (unsigned int i = 0; i < count_of (keywords); ++i) {
-    _current->insert (make_pair (keywords[i].word, 
-				   token (keywords[i].code, 
-					   keywords[i].word)));
-  }  
+symboltbl::symboltbl () {
+  push ();                      /* the bottom level (see level ()) */
 }
 
 /* --------------------------------------------------------------------*/
 
 symboltbl::iterator symboltbl::begin () {
-  return _current->begin ();
+  return _bindings.data () + _scopes.back ();
 }
 
 /* --------------------------------------------------------------------*/
 
 symboltbl::const_iterator symboltbl::begin () const {
-  return _current->begin ();
+  return _bindings.data () + _scopes.back ();
 }
 
 /* --------------------------------------------------------------------*/
 
 symboltbl::iterator symboltbl::end () {
-  return _current->end ();
+  return _bindings.data () + _bindings.size ();
 }
 
 /* --------------------------------------------------------------------*/
 
 symboltbl::const_iterator symboltbl::end () const {
-  return _current->end ();
+  return _bindings.data () + _bindings.size ();
 }
 
 /* --------------------------------------------------------------------*/
 
+/* --- bind the name in the current scope, unless it already is */
 pair<symboltbl::iterator, bool> 
-symboltbl::insert (symboltbl::key_type const & k,
+symboltbl::insert (symboltbl::key_type k,
 		    symboltbl::mapped_type const & m) {  
-  _current = _contents.begin ();  /* force to the current block */
-  return _current->insert (make_pair (k, m));
+  iterator it = find_top (k);
+  if (it != end ()) {
+    return make_pair (it, false);
+  }
+  if (kind::undefined != m.kind) {
+    _spelling.insert (k);       /* (only real definitions are offered) */
+  }
+  binding b = { k, _newest[k], m };
+  b.value.level = level ();
+  _newest[k] = _bindings.size ();
+  _bindings.push_back (b);
+  return make_pair (&_bindings.back (), true);
 }
 
 /* --------------------------------------------------------------------*/
 
-symboltbl::iterator symboltbl::find (symboltbl::key_type const & k) {
-  /* --- look at this scope and all previous blocks */
-  list_type::iterator it = _contents.begin ();
-  for (; it != _contents.end (); ++it) {
-    map_type::iterator jt = it->find (k);
-    if (jt != it->end ()) {
-      _current = it;  /* so that users of our container can make an
-			 assertion that jt != _current->end()  */
-      return jt;
-    }
-  }  
-  /* --- if we didn't find anything, then set it to the top-level 
-     end() iterator. */
-  _current = _contents.begin ();
-  return _current->end ();
+/* --- the newest binding of the name, in any open scope */
+symboltbl::iterator symboltbl::find (symboltbl::key_type k) {
+  handle h = lookup (k);
+  return none == h ? end () : &_bindings[h];
+}
+
+/* --------------------------------------------------------------------*/
+
+symboltbl::handle symboltbl::lookup (symboltbl::key_type k) {
+  if (k < 0) {
+    return none;                /* (atom::none is never bound) */
+  }
+  if (static_cast<size_t> (k) >= _newest.size ()) {
+    _newest.resize (atom::count () > static_cast<size_t> (k) 
+		    ? atom::count () : k + 1, none);
+  }
+  return _newest[k];
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- the name's binding in the current scope only: the newest binding
+   is the only one that can be in it */
+symboltbl::iterator symboltbl::find_top (symboltbl::key_type k) {
+  iterator it = find (k);
+  return it != end () && it->value.level == level () ? it : end ();
 }
 
 /* --------------------------------------------------------------------*/
 
-symboltbl::iterator symboltbl::find_top (symboltbl::key_type const & k) {
-  _current = _contents.begin ();  
-  return _current->find (k);
+/* --- the name in scope that the given one is most likely a misspelling
+   of: the nearest by edit distance, preferring names that also sound
+   alike; names only ever mentioned (never defined) are not offered.
+   The search widens one edit at a time, and stops as soon as nothing
+   further out could beat what it has found */
+symboltbl::key_type symboltbl::suggest (symboltbl::key_type k) {
+  if (atom::none == k) {        /* -- (a name that failed to parse) */
+    return atom::none;
+  }
+  size_t   n = atom::length (k);
+  int      most = n < 4 ? 1 : n < 8 ? 2 : 3;
+  unsigned sound = spelling::soundex (atom::name (k), n);
+  key_type best = atom::none;
+  int      best_score = 0;
+  for (int limit = 1; limit <= most; ++limit) {
+    _spelling.candidates (k, limit, _similar);
+    for (size_t i = 0; i < _similar.size (); ++i) {
+      key_type c = _similar[i];
+      iterator it = find (c);
+      if (c == k || it == end () || kind::undefined == it->value.kind) {
+	continue;
+      }
+      int d = _spelling.distance (k, c);
+      if (d >= static_cast<int> (std::max (n, atom::length (c)))) {
+	continue;               /* (nothing in common: `j' for `x') */
+      }
+      int score = 2 * d
+	- (sound == spelling::soundex (atom::name (c), atom::length (c)));
+      if (atom::none == best || score < best_score 
+	  || (score == best_score && c < best)) {
+	best       = c;
+	best_score = score;
+      }
+    }
+    if (atom::none != best && best_score <= 2 * limit) {
+      break;                    /* (anything further scores 2 limit + 1) */
+    }
+  }
+  return best;
 }
 
 /* --------------------------------------------------------------------*/
 
 void symboltbl::push () {
-  _contents.push_front (map_type ());
-  _current = _contents.begin ();
+  _scopes.push_back (_bindings.size ());
 }
 
 /* --------------------------------------------------------------------*/
 
+/* --- drop the scope's bindings, newest first, uncovering the ones
+   they shadowed */
 void symboltbl::pop () {
-  if (_contents.size () > 1) {
-    _contents.pop_front ();
-    _current = _contents.begin ();
+  if (_scopes.size () > 1) {
+    for (size_t i = _bindings.size (); i > _scopes.back (); --i) {
+      binding const & b = _bindings[i - 1];
+      _newest[b.name] = b.shadowed;
+    }
+    _bindings.erase (_bindings.begin () + _scopes.back (), _bindings.end ());
+    _scopes.pop_back ();
   }
 }
 
 /* --------------------------------------------------------------------*/
 
 int symboltbl::level () const {
-  /* --- keywords are in the bottom level on their own and are not 
-     really in their own scope, per say, so substract that from the
-     scopre level */
-  return _contents.size () - 1; 
+  /* --- the bottom level is not really a scope, per say (it used to
+     hold the keywords, which are now atoms), so substract that from
+     the scope level */
+  return _scopes.size () - 1; 
 }
 
 /* --------------------------------------------------------------------*/
@@ -3,21 +3,35 @@
   Contents: 
   Author  : Ben Burnett
   History : 10.01.2007 file created
+            18.10.2026 scopes are now an undo log over one table,
+	               indexed by atom
+            18.10.2026 holds symbol records, found by handle,
+	               rather than copies of tokens
 ----------------------------------------------------------------------*/
 
 #ifndef SYMBOL_TABLE_H
 #define SYMBOL_TABLE_H
 
+#include "atoms.h"
+#include "spelling.h"
 #include "token.h"
-#include <list>
-#include <map>
-#include <string>
+#include <cstddef>
+#include <utility>
+#include <vector>
 
 /*----------------------------------------------------------------------
-  Forward Declarations
+  Symbol Record - what a name has been defined as
 ----------------------------------------------------------------------*/
 
-class token;
+struct symbol {
+  kind::code kind;
+  type::code type;
+  int        value;             /* a constant's value */
+  int        size;              /* words taken by a variable or array */
+  int        level;             /* scope the name was defined in */
+  int        displacement;      /* a variable's place in its frame */
+  int        start;             /* a procedure's label */
+};
 
 /*----------------------------------------------------------------------
   Main Class - note we don't have all those proper things like copy 
@@ -25,42 +39,64 @@ class token;
   more than one of these.  Of course we could enforce this strictly
   by making it a singleton of some sort ... but I'm just not too 
   concerned about that right now
+
+  The names in scope are found through a table indexed by atom, which
+  holds the newest binding of each name.  Bindings are kept on a stack
+  in the order they were made, and each one remembers the binding it
+  shadows, so the stack doubles as the undo log: closing a scope pops
+  its bindings and puts back whatever they hid.
+
+  A binding is known outside by its handle, its place on the stack,
+  which stays good for as long as the scope it was made in is open.
 ----------------------------------------------------------------------*/
  
 class symboltbl {
 
-private:
-  
-  typedef std::map<std::string, token> map_type;  
-  typedef std::list<map_type>          list_type;
+public:  
 
-  list_type                   _contents;  /* list of all the symbols */
-  mutable list_type::iterator _current;   /* current scope  */  
+  /* --- a name bound in some scope */
+  struct binding {
+    atom::id name;
+    int      shadowed;          /* binding it hides (or -1) */
+    symbol   value;
+  };
+
+  typedef atom::id             key_type;
+  typedef symbol               mapped_type;
+  typedef int                  handle;
+  typedef binding*             iterator;
+  typedef binding const*       const_iterator;
+
+private:
   
-public:  
+  std::vector<binding> _bindings; /* every binding in scope, oldest first */
+  std::vector<int>     _newest;   /* newest binding of each atom (or -1) */
+  std::vector<size_t>  _scopes;   /* where each open scope's bindings start */
+  spelling             _spelling; /* every name ever bound, for suggest () */
+  std::vector<atom::id> _similar; /* scratch for suggest () */
 
-  typedef map_type::key_type           key_type;
-  typedef map_type::mapped_type        mapped_type;
-  typedef map_type::value_type         value_type;
-  typedef map_type::reference          reference;
-  typedef map_type::const_reference    const_reference;
-  typedef map_type::iterator           iterator;
-  typedef map_type::size_type          size_type;
-  typedef map_type::const_iterator     const_iterator;
+public:
       
   symboltbl ();
   
-  iterator begin ();
+  iterator begin ();            /* the bindings of the current scope */
   const_iterator begin () const;
   iterator end ();
   const_iterator end () const;
 
-  std::pair<iterator, bool> insert (key_type const &, mapped_type const &);  
+  std::pair<iterator, bool> insert (key_type, mapped_type const &);  
+
+  iterator find (key_type); 
+  handle lookup (key_type);     /* find (), as a handle (or none) */
+  iterator find_top (key_type);   
+  key_type suggest (key_type);  /* a defined name like it (or none) */
 
-  iterator find (key_type const &); 
-  iterator find_top (key_type const &);   
-  /* notice there is no const version of the above, we will implement it 
-     when -- and if -- it become nessessary (which I hope it doesn't) */
+  symbol const & operator[] (handle h) const { 
+    return h < 0 ? undefined : _bindings[h].value; 
+  }
+  atom::id name (handle h) const { 
+    return h < 0 ? atom::none : _bindings[h].name; 
+  }
 
   void push ();                 /* create a new scope (or block) */
   void pop ();                  /* close the current scope */  
@@ -69,6 +105,9 @@ public:
   void push_storage (int);
   void pop_storage (int);
 
+  static constexpr handle none = -1;
+  static const symbol undefined; /* what none stands for */
+
 };
 
 #endif
@@ -16,7 +16,6 @@
   Namespace Inclusions
 ----------------------------------------------------------------------*/
 
-using std::string;
 
 /*----------------------------------------------------------------------
   Preprocessor Definitions
@@ -133,134 +132,6 @@ const token token::null (NONE);
   Main Methods
 ----------------------------------------------------------------------*/
 
-token::token (token_code c, string const & s) 
-  : _code (c), _svalue (s), _ivalue (0), _kind (kind::undefined), 
-    _type (type::universal), _size (1), _level (0), 
-    _displacement (0), _start (-1) {
-}
-
-/* --------------------------------------------------------------------*/
-
-token::token (token_code c, int i) 
-  : _code (c), _svalue (), _ivalue (i), _kind (kind::undefined), 
-    _type (type::universal), _size (1), _level (0), 
-    _displacement (0), _start (-1) {
-}
-
-/* --------------------------------------------------------------------*/
-
-token::token (token_code c, kind::code kind, type::code type,
-	       std::string const & svalue, int ivalue, int size, int level, 
-	       int displacement, int start) 
-  : _code (c), _svalue (svalue), _ivalue (ivalue), _kind (kind), 
-    _type (type), _size (size), _level (level), 
-    _displacement (displacement), _start (start) {
-}
-
-/* --------------------------------------------------------------------*/
-
-void token::set_value (std::string const & s) {
-  _svalue = s;
-}
-
-/* --------------------------------------------------------------------*/
-
-void token::set_value (int i) {
-  _ivalue = i;
-}
-
-/* --------------------------------------------------------------------*/
-
-void token::set_type (type::code t) {
-  _type = t;
-}
-
-/* --------------------------------------------------------------------*/
-
-void token::set_kind (kind::code k) {
-  _kind = k;
-}
-
-/* --------------------------------------------------------------------*/
-
-void token::set_size (int n) {
-  _size = n;
-}
-
-/* --------------------------------------------------------------------*/
-
-void token::set_level (int l) {
-  _level = l;
-}
-
-/* --------------------------------------------------------------------*/
-
-void token::set_displacement (int d) {
-  _displacement = d;
-}
-
-/* --------------------------------------------------------------------*/
-
-void token::set_start (int l) {
-  _start = l;
-}
-
-/* --------------------------------------------------------------------*/
-
-token::operator token_code () const {
-  return _code;
-}
-
-/* --------------------------------------------------------------------*/
-
-void token::value (string & s) const {
-  s = _svalue;
-}
-
-/* --------------------------------------------------------------------*/
-
-void token::value (int & i) const {
-  i = _ivalue;
-}
-
-/* --------------------------------------------------------------------*/
-
-type::code token::type () const {
-  return _type;
-}
-
-/* --------------------------------------------------------------------*/
-
-kind::code token::kind () const {
-  return _kind;
-}
-
-/* --------------------------------------------------------------------*/
-
-int token::size () const {
-  return _size;
-}
-
-/* --------------------------------------------------------------------*/
-  
-int token::level () const {
-  return _level;
-}
-
-/* --------------------------------------------------------------------*/
-
-int token::displacement () const {
-  return _displacement;
-}
-
-/* --------------------------------------------------------------------*/
-
-int token::start () const {
-  return _start;
-}
-
-/* --------------------------------------------------------------------*/
-
 const char* token::name (token_code c) {
   assert (c >= FIRST_TOKEN && c <= LAST_TOKEN);
   return token_names[c];
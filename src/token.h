@@ -3,19 +3,22 @@
   Contents: 
   Author  : Ben Burnett
   History : 10.01.2007 file created
+            18.10.2026 split in two: the token is now only what was
+	               scanned, the rest is a symbol (symboltbl.h)
 ----------------------------------------------------------------------*/
 
 #ifndef TOKEN_H
 #define TOKEN_H
 
+#include "atoms.h"
 #include "emitter.h"
-#include <string>
+#include <type_traits>
 
 /*----------------------------------------------------------------------
   Token Codes
 ----------------------------------------------------------------------*/
 
-enum token_code {
+enum token_code : int {
 
   FIRST_TOKEN = -1,
   
@@ -106,51 +109,31 @@ namespace type {
 };
 
 /*----------------------------------------------------------------------
-  Main Class
+  Main Class - a lexical token: what was seen, and where.  Tokens are
+  small and trivially copyable, so they are passed around by value;
+  what a name means is kept in the symbol table (see symboltbl.h)
 ----------------------------------------------------------------------*/
 
 class token {  
   
  private:
   
-  token_code  _code;  
-  std::string _svalue;
-  int         _ivalue;
-  kind::code  _kind;
-  type::code  _type;  
-  int         _size;  
-  int         _level;
-  int         _displacement;
-  int         _start;
+  token_code _code;  
+  int        _value;            /* the atom of a word, or a numeral */
+  unsigned   _offset;           /* where it starts in the source */
+  unsigned   _length;           /* and how many characters it spans */
 
  public:
 
-  token (token_code, std::string const &);
-  token (token_code, int);
-  token (token_code = NONE, 
-	  kind::code = kind::undefined,
-	  type::code = type::universal, 	  
-	  std::string const & = std::string (),
-	  int = 0, int = 0, int = 0, int = 0, int = -1);  
+  constexpr token (token_code c = NONE, int value = 0, 
+		   unsigned offset = 0, unsigned length = 0)
+    : _code (c), _value (value), _offset (offset), _length (length) {}
   
-  void set_value (std::string const &);
-  void set_value (int);
-  void set_type (type::code);
-  void set_kind (kind::code);
-  void set_size (int);  
-  void set_level (int);
-  void set_displacement (int);
-  void set_start (int);
-  
-  operator token_code () const;
-  void value (std::string &) const;
-  void value (int &) const;
-  type::code type () const;
-  kind::code kind () const;
-  int size () const;  
-  int level () const;
-  int displacement () const;
-  int start () const;
+  operator token_code () const  { return _code; }
+  atom::id spelling () const    { return static_cast<atom::id> (_value); }
+  int      value () const       { return _value; }
+  unsigned offset () const      { return _offset; }
+  unsigned length () const      { return _length; }
 
   static const char* name (token_code);
   static const char* friendly_name (token_code);
@@ -159,6 +142,10 @@ class token {
   
 };
 
+static_assert (sizeof (token) == 16, "a token should fit in 16 bytes");
+static_assert (std::is_trivially_copyable<token>::value,
+	       "tokens are copied as plain words");
+
 #endif
 
 /*----------------------------------------------------------------------
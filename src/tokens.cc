@@ -0,0 +1,53 @@
+/*----------------------------------------------------------------------
+  File    : tokens.cc
+  Contents: A whole source's tokens, held as parallel arrays
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "tokens.h"
+
+/*----------------------------------------------------------------------
+  Main Methods
+----------------------------------------------------------------------*/
+
+void token_buffer::clear () {
+  _codes.clear ();
+  _values.clear ();
+  _offsets.clear ();
+  _lengths.clear ();
+}
+
+/* --------------------------------------------------------------------*/
+
+void token_buffer::reserve (size_t n) {
+  _codes.reserve (n);
+  _values.reserve (n);
+  _offsets.reserve (n);
+  _lengths.reserve (n);
+}
+
+/* --------------------------------------------------------------------*/
+
+void token_buffer::push_back (token const & t) {
+  _codes.push_back (static_cast<signed char> (static_cast<token_code> (t)));
+  _values.push_back (t.value ());
+  _offsets.push_back (t.offset ());
+  _lengths.push_back (t.length ());
+}
+
+/* --------------------------------------------------------------------*/
+
+/* --- the first token, from the given one on, whose code is in the
+   set; or the last token (END_OF_FILE) if there is none */
+size_t token_buffer::find (size_t from, token_set const & set) const {
+  size_t n = _codes.size ();
+  while (from < n && !set.count (static_cast<token_code> (_codes[from]))) {
+    ++from;
+  }
+  return from < n ? from : n - 1;
+}
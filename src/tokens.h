@@ -0,0 +1,58 @@
+/*----------------------------------------------------------------------
+  File    : tokens.h
+  Contents: A whole source's tokens, held as parallel arrays
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#ifndef TOKENS_H
+#define TOKENS_H
+
+#include "setops.h"
+#include "token.h"
+#include <cstddef>
+#include <vector>
+
+/*----------------------------------------------------------------------
+  Main Class - every token in a source, in order, ending with the
+  END_OF_FILE token.  Each field has an array of its own, so a search
+  for a token code (say, when the parser recovers from an error) runs
+  over the codes alone, a byte per token
+----------------------------------------------------------------------*/
+
+class token_buffer {
+
+private:
+
+  std::vector<signed char> _codes;   /* token codes (all fit in a byte) */
+  std::vector<int>         _values;  /* atoms and numerals */
+  std::vector<unsigned>    _offsets; /* where each starts in the source */
+  std::vector<unsigned>    _lengths; /* and how long each is */
+
+public:
+
+  void clear ();
+  void reserve (size_t);
+  void push_back (token const&);
+
+  size_t     size () const      { return _codes.size (); }
+  bool       empty () const     { return _codes.empty (); }
+  token_code code (size_t i) const { 
+    return static_cast<token_code> (_codes[i]); 
+  }
+  token      operator[] (size_t i) const {
+    return token (code (i), _values[i], _offsets[i], _lengths[i]);
+  }
+
+  size_t find (size_t, token_set const&) const;
+
+};
+
+#endif
+
+/*----------------------------------------------------------------------
+  Emacs Configuration
+  Local Variables:
+  mode: C++
+  End:
+----------------------------------------------------------------------*/
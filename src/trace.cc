@@ -0,0 +1,154 @@
+/*----------------------------------------------------------------------
+  File    : trace.cc
+  Contents: Counts and times the parser's work, per rule of the grammar
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef PARSER_TRACE
+
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+/*----------------------------------------------------------------------
+  Namespace Inclusions
+----------------------------------------------------------------------*/
+
+using std::cerr;
+using std::ofstream;
+using std::ostream;
+using std::setw;
+using std::string;
+using std::vector;
+
+/*----------------------------------------------------------------------
+  Global Variables
+----------------------------------------------------------------------*/
+
+unsigned long trace::consumed = 0;
+
+/* --- a call still running: its rule, and where it started, less what
+   the calls it made have taken so far */
+struct frame {
+  trace::rule  *rule;
+  long long     start, inner_time;
+  unsigned long first, inner_tokens;
+};
+
+static vector<trace::rule*> rules; /* in the order first entered */
+static vector<frame>        calls;
+
+/*----------------------------------------------------------------------
+  Helper Functions
+----------------------------------------------------------------------*/
+
+static long long now () {
+  return std::chrono::duration_cast<std::chrono::nanoseconds> 
+    (std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+}
+
+/* --------------------------------------------------------------------*/
+
+static bool busier (trace::rule const *a, trace::rule const *b) {
+  return a->own_time > b->own_time;
+}
+
+/*----------------------------------------------------------------------
+  Main Methods
+----------------------------------------------------------------------*/
+
+/* --- a handler's name is given with its parameters, if it has any */
+trace::rule::rule (char const *s)
+  : name (s, s + strcspn (s, " (")), calls (0), tokens (0), 
+    own_tokens (0), time (0), own_time (0), active (0) {
+  rules.push_back (this);
+}
+
+/*----------------------------------------------------------------------
+  Main Functions
+----------------------------------------------------------------------*/
+
+/* --- the rule for a handler, shared by every place that enters it */
+trace::rule & trace::named (char const *s) {
+  string name (s, s + strcspn (s, " ("));
+  for (size_t i = 0; i < rules.size (); ++i) {
+    if (rules[i]->name == name) {
+      return *rules[i];
+    }
+  }
+  return *new rule (s);
+}
+
+/* --------------------------------------------------------------------*/
+
+void trace::enter (rule & r) {
+  ++r.calls;
+  ++r.active;
+  frame f = { &r, now (), 0, consumed, 0 };
+  calls.push_back (f);
+}
+
+/* --------------------------------------------------------------------*/
+
+void trace::leave () {
+  frame f = calls.back ();
+  calls.pop_back ();
+  long long     t = now () - f.start;
+  unsigned long k = consumed - f.first;
+  f.rule->own_time   += t - f.inner_time;
+  f.rule->own_tokens += k - f.inner_tokens;
+  if (0 == --f.rule->active) {  /* (a nested call is already counted */
+    f.rule->time   += t;        /* in the outermost one) */
+    f.rule->tokens += k;
+  }
+  if (!calls.empty ()) {
+    calls.back ().inner_time   += t;
+    calls.back ().inner_tokens += k;
+  }
+}
+
+/* --------------------------------------------------------------------*/
+
+void trace::report () {
+  ofstream     file;
+  char const  *fn = getenv ("PLC_TRACE");
+  if (fn && *fn) {
+    file.open (fn, ofstream::out | ofstream::app);
+  }
+  ostream & out = file.is_open () ? static_cast<ostream&> (file) : cerr;
+  vector<rule*> sorted (rules);
+  std::stable_sort (sorted.begin (), sorted.end (), busier);
+  out << std::left << setw (22) << "rule" << std::right 
+      << setw (10) << "calls" << setw (11) << "tokens" 
+      << setw (11) << "own tokens" << setw (11) << "ms" 
+      << setw (11) << "own ms" << '\n' << std::fixed 
+      << std::setprecision (3);
+  for (size_t i = 0; i < sorted.size (); ++i) {
+    rule const & r = *sorted[i];
+    out << std::left << setw (22) << r.name << std::right 
+	<< setw (10) << r.calls << setw (11) << r.tokens 
+	<< setw (11) << r.own_tokens << setw (11) << r.time / 1e6
+	<< setw (11) << r.own_time / 1e6 << '\n';
+  }
+  out.flush ();
+}
+
+#endif
+
+/*----------------------------------------------------------------------
+  Emacs Configuration
+  Local Variables:
+  mode: C++
+  End:
+----------------------------------------------------------------------*/
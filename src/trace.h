@@ -0,0 +1,61 @@
+/*----------------------------------------------------------------------
+  File    : trace.h
+  Contents: Counts and times the parser's work, per rule of the grammar
+  Author  : Ben Burnett
+  History : 18.10.2026 file created
+----------------------------------------------------------------------*/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <string>
+
+/*----------------------------------------------------------------------
+  Parser Trace - in a build configured with --enable-trace, each of the
+  parser's handlers (and each kind of statement) is a rule here, which
+  counts the calls made to it, and the tokens consumed and the time
+  taken while it was running: in all, counting only the outermost of
+  any nested calls, and on its own, less what the rules it called took.
+  The table is written out, busiest rule first, when a parse finishes:
+  to the file named by the PLC_TRACE environment variable, or else to
+  stderr.  Otherwise, the parser's macros expand to nothing, and none
+  of this is compiled in (see parser.cc).
+----------------------------------------------------------------------*/
+
+namespace trace {
+
+  class rule {
+
+  public:
+
+    std::string   name;
+    unsigned long calls,
+                  tokens,       /* consumed in all, */
+                  own_tokens;   /* and not by a rule it called */
+    long long     time,         /* nanoseconds, likewise */
+                  own_time;
+    int           active;       /* calls not yet returned from */
+
+    explicit rule (char const*);
+
+  };
+
+  extern unsigned long consumed; /* tokens, so far */
+
+  inline void consume () { ++consumed; }
+
+  rule & named (char const*);   /* made on first use */
+  void enter (rule&);
+  void leave ();                /* the rule entered last */
+  void report ();
+
+}
+
+#endif
+
+/*----------------------------------------------------------------------
+  Emacs Configuration
+  Local Variables:
+  mode: C++
+  End:
+----------------------------------------------------------------------*/
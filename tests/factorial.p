@@ -0,0 +1,22 @@
+$ Program: recursive factorial, with the results kept in an array
+begin
+   integer n, r, i;
+   integer array f[10];
+
+   proc fact
+   begin
+      integer k;
+      if n = 0 -> r := 1; 
+      [] n > 0 -> k := n; n := n - 1; call fact; r := r * k; 
+      fi;
+   end;
+
+   i := 1;
+   do ~(i > 10) ->
+      n := i; 
+      call fact;
+      f[i] := r;
+      i := i + 1;
+   od;
+   write f[1], f[5], f[10];
+end.
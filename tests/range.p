@@ -0,0 +1,7 @@
+begin
+   integer i;
+   integer array a[10];
+   i := 1;
+   do ~(i > 10) -> a[i] := i; i := i + 1; od;
+   write a[i]; $ error! index out of bounds (at run-time)
+end.
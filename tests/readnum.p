@@ -0,0 +1,5 @@
+begin
+   integer x;
+   read 5;          $ not a variable: the name is missing, so there is
+   write x;         $ no spelling to suggest from
+end.